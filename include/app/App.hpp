@@ -1,8 +1,11 @@
 #pragma once
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
+#include <fstream>
 #include <memory>
 #include "gfx/TriangleRenderer.hpp"
+#include "gfx/FrameStats.hpp"
+#include "gfx/RenderLayer.hpp"
 #include "gfx/SpriteBatch.hpp"
 #include "gfx/Texture2D.hpp"
 #include "ui/BitmapFont.hpp"
@@ -18,15 +21,29 @@ public:
     bool init(int w = 800, int h = 600, const char* title = "GL App");
     void run();
 
+    // Opt-in: while the scene is not animating, block in glfwWaitEventsTimeout instead of
+    // polling and skip update-free frames' render + swap (also APP_EVENT_DRIVEN=1)
+    void setEventDriven(bool on) { eventDriven_ = on; wake_ = true; }
+    bool eventDriven() const { return eventDriven_; }
+    unsigned long long idleFrames() const { return idleFrames_; } // frames not drawn
+
     static void onError(int code, const char* desc);
     static void onKey(GLFWwindow* win, int key, int sc, int action, int mods);
     static void onScroll(GLFWwindow* win, double xoff, double yoff);
     static void onMouseButton(GLFWwindow* win, int button, int action, int mods);
     static void onCursorPos(GLFWwindow* win, double x, double y);
+    static void onRefresh(GLFWwindow* win);
+
+    // Counters of the last completed frame
+    const FrameStats& lastFrameStats() const { return lastStats_; }
 
 private:
+    void renderScene(const glm::mat4& vp);   // UI pass + text pass
+    static void wake(GLFWwindow* win);       // input arrived: the next frame is drawn
+
     GLFWwindow* window_ = nullptr;
     SpriteBatch spriteBatch_;
+    RenderLayer menuLayer_;   // menu drawn once per change, composited as one quad
     std::unique_ptr<IScene> scene_;   // < host ANY scene
 
     Texture2D fontTex_;
@@ -37,7 +54,18 @@ private:
     int fbw_ = 0, fbh_ = 0;
     bool prevMouseLeftDown_ = false;
 
+    // event-driven redraw
+    static constexpr double kIdleTimeout = 0.5; // s between wakeups with no input (scene timers)
+    bool eventDriven_ = false;
+    bool wake_ = true;                 // draw the next frame regardless of the scene
+    unsigned long long idleFrames_ = 0;
+
     // pan state for MMB drag
     bool   panning_ = false;
     double lastX_ = 0.0, lastY_ = 0.0;
+
+    // Per-frame stats log: APP_FRAME_STATS=<path> (.json/.jsonl -> JSON lines, else CSV)
+    FrameStats lastStats_{};
+    std::ofstream statsLog_;
+    bool statsJson_ = false;
 };
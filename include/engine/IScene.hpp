@@ -23,6 +23,12 @@ public:
     virtual void update(const FrameInput& in, float dt) = 0;
     virtual void render(SpriteBatch& batch) const = 0;
 
+    // Event-driven redraw (App::setEventDriven): while no scene animates, App sleeps until
+    // input or a timeout and only draws when takeVisualChange() or input says so
+    virtual bool animating() const { return true; }
+    // True once after update() changed what render() draws (default: every frame)
+    virtual bool takeVisualChange() { return true; }
+
     // Camera access so App callbacks (scroll/pan) can modify it
     virtual OrthoCamera2D& camera() = 0;
     virtual const OrthoCamera2D& camera() const = 0;
@@ -1,7 +1,9 @@
 #pragma once
 #include <glm/glm.hpp>
 #include "gfx/OrthoCamera2D.hpp"
+#include "gfx/ParticleSystem.hpp"
 #include "gfx/SpriteBatch.hpp"
+#include "gfx/StaticSpriteBatch.hpp"
 
 struct InputState {
     bool leftUp = false, leftDown = false;
@@ -27,6 +29,7 @@ private:
     void clampPaddles();
     void collideWithWalls();
     void collideWithPaddles();
+    void sparkBurst(const glm::vec2& at, const glm::vec2& normal, int count);
     static bool circleAabb(const glm::vec2& c, float r,
         const glm::vec2& bmin, const glm::vec2& bmax,
         glm::vec2& outNormal, float& outPen);
@@ -37,5 +40,8 @@ private:
     float courtHalfH_ = 10.0f;
     Paddle L_{}, R_{};
     Ball ball_{};
+    mutable StaticSpriteBatch court_; // center line, built on first render
     int scoreL_ = 0, scoreR_ = 0;
+    ParticleSystem trail_;   // fading dots behind the ball
+    ParticleSystem sparks_;  // paddle/wall hits and scoring
 };
@@ -0,0 +1,82 @@
+// include/gfx/AtlasBuilder.hpp
+#pragma once
+#include <glad/glad.h>
+#include <cstdint>
+#include <vector>
+#include <glm/vec4.hpp>
+
+// Where an image ended up: its page texture and uv rect (u0, v0, u1, v1), ready for
+// Sprite::texture / Sprite::uv. Pixel coordinates are in the page, bottom row first.
+struct AtlasRegion {
+    GLuint texture = 0;        // 0 = not packed (build() not called, or the image did not fit)
+    glm::vec4 uv{ 0.0f, 0.0f, 1.0f, 1.0f };
+    int page = -1;
+    int x = 0, y = 0, width = 0, height = 0;
+
+    // A sub-rect given in the source image's 0..1 uvs (font cell, animation frame) in atlas uvs
+    glm::vec4 sub(const glm::vec4& local) const {
+        const float du = uv.z - uv.x, dv = uv.w - uv.y;
+        return { uv.x + local.x * du, uv.y + local.y * dv, uv.x + local.z * du, uv.y + local.w * dv };
+    }
+};
+
+// Packs many images into a few RGBA8 pages at load time, so sprites that used separate
+// textures share one and stay in the same batch run. Skyline bottom-left packing, tallest
+// images first; each image gets `padding` pixels on every side filled with copies of its
+// edge texels (extrusion), so linear filtering does not pull in the neighbours. Mipmapped
+// pages stop at level log2(padding): past that a texel spans more than the padding.
+//
+//   AtlasBuilder atlas;
+//   auto panda = atlas.add("assets/Panda.png"), run = atlas.add("assets/run.png");
+//   atlas.build();
+//   s.texture = atlas.region(panda).texture; s.uv = atlas.region(panda).uv;
+class AtlasBuilder {
+public:
+    using Handle = int; // index into the regions, -1 = load failed
+
+    // pageSize is capped by GL_MAX_TEXTURE_SIZE at build(); pages shrink to the used power of two
+    explicit AtlasBuilder(int pageSize = 2048, int padding = 2);
+    ~AtlasBuilder() { shutdown(); }
+    AtlasBuilder(const AtlasBuilder&) = delete;
+    AtlasBuilder& operator=(const AtlasBuilder&) = delete;
+
+    // -1 if the file cannot be loaded, or after releasePixels()
+    Handle add(const char* path);                                // any stb_image format, as RGBA8
+    Handle add(const unsigned char* rgba, int width, int height); // copied; bottom row first
+
+    // Packs everything added so far and uploads the pages, replacing earlier ones (handles stay
+    // valid, regions move). False if an image does not fit even an empty page (texture 0), or
+    // after releasePixels(), which leaves the pages and regions as they are.
+    bool build(bool nearest = true);
+    // Drop the CPU copies once the set is final: pages and regions stay valid, but the atlas
+    // can no longer grow (add() and build() refuse until shutdown())
+    void releasePixels();
+    void shutdown();      // deletes the pages and forgets every image
+
+    const AtlasRegion& region(Handle h) const { return m_regions[static_cast<size_t>(h)]; }
+    int imageCount() const { return static_cast<int>(m_regions.size()); }
+    int pageCount() const { return static_cast<int>(m_pages.size()); }
+    GLuint pageTexture(int page) const { return m_pages[static_cast<size_t>(page)]; }
+
+private:
+    struct Image {
+        std::vector<unsigned char> rgba; // kept for rebuilds until releasePixels()
+        int width = 0, height = 0;
+    };
+    struct SkylineNode { int x, y, width; }; // a segment of the packed outline
+
+    struct Page {
+        std::vector<SkylineNode> skyline;
+        int usedW = 0, usedH = 0;
+    };
+
+    static bool place(Page& page, int size, int w, int h, int& outX, int& outY);
+    GLuint upload(const std::vector<unsigned char>& pixels, int w, int h, bool nearest);
+
+    int m_pageSize;
+    int m_padding;
+    std::vector<Image> m_images;
+    std::vector<AtlasRegion> m_regions;
+    std::vector<GLuint> m_pages;
+    bool m_released = false; // releasePixels() was called: the set is frozen
+};
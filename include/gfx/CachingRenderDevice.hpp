@@ -0,0 +1,166 @@
+// include/gfx/CachingRenderDevice.hpp
+#pragma once
+#include <glad/glad.h>
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "gfx/FrameStats.hpp"
+#include "gfx/RenderDevice.hpp"
+
+// Shadows the GL state the gfx classes touch and forwards only calls that change something:
+// program, VAO, buffer bindings, active unit + texture per unit, blend/depth state and uniform
+// values (per program). Everything else goes straight through. device() hands out one of these
+// in front of the active device, so callers can bind "just in case" without paying for it.
+// GL calls made behind its back (raw gl*, other libraries) must be followed by invalidate().
+class CachingRenderDevice final : public RenderDevice {
+public:
+    explicit CachingRenderDevice(RenderDevice* inner) : m_inner(inner) { invalidate(); }
+
+    void setInner(RenderDevice* inner) { m_inner = inner; invalidate(); }
+    RenderDevice* inner() const { return m_inner; }
+
+    // Off: every call is forwarded (A/B, debugging); the shadow state keeps tracking
+    void setEnabled(bool on) { m_enabled = on; invalidate(); }
+    bool enabled() const { return m_enabled; }
+
+    // Forget everything: the next call of each kind is forwarded
+    void invalidate();
+
+    void genBuffers(GLsizei n, GLuint* ids) override { m_inner->genBuffers(n, ids); }
+    void deleteBuffers(GLsizei n, const GLuint* ids) override;
+    void bindBuffer(GLenum target, GLuint id) override;
+    void bufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage) override { m_inner->bufferData(target, size, data, usage); }
+    void bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data) override { m_inner->bufferSubData(target, offset, size, data); }
+    void* mapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access) override { return m_inner->mapBufferRange(target, offset, length, access); }
+    GLboolean unmapBuffer(GLenum target) override { return m_inner->unmapBuffer(target); }
+    void bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size) override {
+        m_inner->bindBufferRange(target, index, buffer, offset, size);
+    }
+
+    GLsync fenceSync(GLenum condition, GLbitfield flags) override { return m_inner->fenceSync(condition, flags); }
+    GLenum clientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout) override { return m_inner->clientWaitSync(sync, flags, timeout); }
+    void deleteSync(GLsync sync) override { m_inner->deleteSync(sync); }
+
+    void genVertexArrays(GLsizei n, GLuint* ids) override { m_inner->genVertexArrays(n, ids); }
+    void deleteVertexArrays(GLsizei n, const GLuint* ids) override;
+    void bindVertexArray(GLuint id) override;
+    void enableVertexAttribArray(GLuint index) override { m_inner->enableVertexAttribArray(index); }
+    void vertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* offset) override {
+        m_inner->vertexAttribPointer(index, size, type, normalized, stride, offset);
+    }
+    void vertexAttribIPointer(GLuint index, GLint size, GLenum type, GLsizei stride, const void* offset) override {
+        m_inner->vertexAttribIPointer(index, size, type, stride, offset);
+    }
+    void vertexAttribDivisor(GLuint index, GLuint divisor) override { m_inner->vertexAttribDivisor(index, divisor); }
+
+    void genTextures(GLsizei n, GLuint* ids) override { m_inner->genTextures(n, ids); }
+    void deleteTextures(GLsizei n, const GLuint* ids) override;
+    void bindTexture(GLenum target, GLuint id) override;
+    void activeTexture(GLenum unit) override;
+    void texParameteri(GLenum target, GLenum name, GLint value) override { m_inner->texParameteri(target, name, value); }
+    void texImage2D(GLenum target, GLint level, GLint internalFormat, GLsizei w, GLsizei h,
+        GLint border, GLenum format, GLenum type, const void* pixels) override {
+        m_inner->texImage2D(target, level, internalFormat, w, h, border, format, type, pixels);
+    }
+    void generateMipmap(GLenum target) override { m_inner->generateMipmap(target); }
+    void pixelStorei(GLenum name, GLint value) override { m_inner->pixelStorei(name, value); }
+    void texBuffer(GLenum target, GLenum internalFormat, GLuint buffer) override { m_inner->texBuffer(target, internalFormat, buffer); }
+
+    void genFramebuffers(GLsizei n, GLuint* ids) override { m_inner->genFramebuffers(n, ids); }
+    void deleteFramebuffers(GLsizei n, const GLuint* ids) override { m_inner->deleteFramebuffers(n, ids); }
+    void bindFramebuffer(GLenum target, GLuint id) override { m_inner->bindFramebuffer(target, id); }
+    void framebufferTexture2D(GLenum target, GLenum attachment, GLenum texTarget, GLuint tex, GLint level) override {
+        m_inner->framebufferTexture2D(target, attachment, texTarget, tex, level);
+    }
+    GLenum checkFramebufferStatus(GLenum target) override { return m_inner->checkFramebufferStatus(target); }
+    void genRenderbuffers(GLsizei n, GLuint* ids) override { m_inner->genRenderbuffers(n, ids); }
+    void deleteRenderbuffers(GLsizei n, const GLuint* ids) override { m_inner->deleteRenderbuffers(n, ids); }
+    void bindRenderbuffer(GLenum target, GLuint id) override { m_inner->bindRenderbuffer(target, id); }
+    void renderbufferStorage(GLenum target, GLenum internalFormat, GLsizei w, GLsizei h) override {
+        m_inner->renderbufferStorage(target, internalFormat, w, h);
+    }
+    void framebufferRenderbuffer(GLenum target, GLenum attachment, GLenum rbTarget, GLuint rb) override {
+        m_inner->framebufferRenderbuffer(target, attachment, rbTarget, rb);
+    }
+
+    GLuint createShader(GLenum type) override { return m_inner->createShader(type); }
+    void shaderSource(GLuint shader, GLsizei count, const GLchar* const* src, const GLint* len) override { m_inner->shaderSource(shader, count, src, len); }
+    void compileShader(GLuint shader) override { m_inner->compileShader(shader); }
+    void getShaderiv(GLuint shader, GLenum name, GLint* out) override { m_inner->getShaderiv(shader, name, out); }
+    void getShaderInfoLog(GLuint shader, GLsizei max, GLsizei* len, GLchar* log) override { m_inner->getShaderInfoLog(shader, max, len, log); }
+    void deleteShader(GLuint shader) override { m_inner->deleteShader(shader); }
+    GLuint createProgram() override { return m_inner->createProgram(); }
+    void attachShader(GLuint prog, GLuint shader) override { m_inner->attachShader(prog, shader); }
+    void linkProgram(GLuint prog) override;
+    void getProgramiv(GLuint prog, GLenum name, GLint* out) override { m_inner->getProgramiv(prog, name, out); }
+    void getProgramInfoLog(GLuint prog, GLsizei max, GLsizei* len, GLchar* log) override { m_inner->getProgramInfoLog(prog, max, len, log); }
+    void deleteProgram(GLuint prog) override;
+    void useProgram(GLuint prog) override;
+    GLint getUniformLocation(GLuint prog, const GLchar* name) override { return m_inner->getUniformLocation(prog, name); }
+    void uniform1i(GLint loc, GLint v) override;
+    void uniform1iv(GLint loc, GLsizei count, const GLint* v) override;
+    void uniformMatrix4fv(GLint loc, GLsizei count, GLboolean transpose, const GLfloat* m) override;
+    GLuint getUniformBlockIndex(GLuint prog, const GLchar* name) override { return m_inner->getUniformBlockIndex(prog, name); }
+    void uniformBlockBinding(GLuint prog, GLuint block, GLuint binding) override { m_inner->uniformBlockBinding(prog, block, binding); }
+
+    void enable(GLenum cap) override { setCap(cap, true); }
+    void disable(GLenum cap) override { setCap(cap, false); }
+    void blendFunc(GLenum src, GLenum dst) override;
+    void blendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcA, GLenum dstA) override;
+    void depthFunc(GLenum func) override;
+    void depthMask(GLboolean flag) override;
+    void clear(GLbitfield mask) override { m_inner->clear(mask); }
+    void clearColor(GLfloat r, GLfloat g, GLfloat b, GLfloat a) override { m_inner->clearColor(r, g, b, a); }
+    void viewport(GLint x, GLint y, GLsizei w, GLsizei h) override { m_inner->viewport(x, y, w, h); }
+
+    void drawElements(GLenum mode, GLsizei count, GLenum type, const void* indices) override { m_inner->drawElements(mode, count, type, indices); }
+    void drawElementsBaseVertex(GLenum mode, GLsizei count, GLenum type, const void* indices, GLint baseVertex) override {
+        m_inner->drawElementsBaseVertex(mode, count, type, indices, baseVertex);
+    }
+    void drawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instances) override {
+        m_inner->drawArraysInstanced(mode, first, count, instances);
+    }
+
+    void getIntegerv(GLenum name, GLint* out) override { m_inner->getIntegerv(name, out); }
+    void getFloatv(GLenum name, GLfloat* out) override { m_inner->getFloatv(name, out); }
+    GLboolean isEnabled(GLenum cap) override; // blend/depth test answered from the shadow when known
+
+private:
+    static constexpr GLuint kUnknown = ~GLuint(0);
+    static constexpr int kUnits = 32;     // texture units tracked; higher ones pass through
+    enum BufferSlot { ArrayBuffer, ElementBuffer, TextureBuffer, BufferSlots };
+    enum TextureSlot { Tex2D, TexBuffer, TextureSlots };
+    enum CapSlot { Blend, DepthTest, CapSlots };
+    enum class Tri : std::uint8_t { Unknown, Off, On };
+
+    static int bufferSlot(GLenum target);
+    static int textureSlot(GLenum target);
+    static int capSlot(GLenum cap);
+    void setCap(GLenum cap, bool on);
+    // True if (current program, loc) already holds these bits; records them otherwise
+    bool sameUniform(GLint loc, const void* data, size_t bytes);
+    void forgetProgram(GLuint prog);
+    // Called once a call was found redundant: drop it, unless caching is off
+    bool skip() const {
+        if (!m_enabled) return false;
+        ++frameStats().skippedStateCalls;
+        return true;
+    }
+
+    RenderDevice* m_inner;
+    bool m_enabled = true;
+
+    GLuint m_program = kUnknown;
+    GLuint m_vao = kUnknown;
+    std::array<GLuint, BufferSlots> m_buffers{};
+    GLenum m_activeUnit = 0;   // GL_TEXTURE0 + i, 0 = unknown
+    std::array<std::array<GLuint, TextureSlots>, kUnits> m_textures{};
+    std::array<Tri, CapSlots> m_caps{};
+    std::array<GLenum, 4> m_blend{};   // src/dst RGB, src/dst alpha; 0 = unknown
+    GLenum m_depthFunc = 0;
+    Tri m_depthMask = Tri::Unknown;
+
+    // (program << 32 | location) -> raw value bits
+    std::unordered_map<std::uint64_t, std::vector<std::uint32_t>> m_uniforms;
+};
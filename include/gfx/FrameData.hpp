@@ -0,0 +1,68 @@
+// include/gfx/FrameData.hpp
+#pragma once
+#include <glad/glad.h>
+#include <cstddef>
+#include <vector>
+#include <glm/mat4x4.hpp>
+#include <glm/vec4.hpp>
+#include "gfx/StreamBuffer.hpp"
+
+// Uniform block binding point of FrameData; ShaderProgram points every program that declares
+// the block at it when linking.
+constexpr GLuint kFrameDataBinding = 0;
+
+// CPU side of the std140 block every shader in shaders/ declares:
+//   layout(std140) uniform FrameData { mat4 u_VP; mat4 u_InvVP; vec4 u_Viewport; vec4 u_Time; };
+struct FrameDataBlock {
+    glm::mat4 vp;         // world -> clip of the current view
+    glm::mat4 invVp;      // clip -> world (picking, screen-space effects)
+    glm::vec4 viewport;   // width, height, 1/width, 1/height in pixels
+    glm::vec4 time;       // seconds since start, frame delta, frame index, 0
+};
+static_assert(sizeof(FrameDataBlock) == 160, "FrameDataBlock must match the std140 layout");
+
+// Camera data shared by all programs. Each view is written once per frame into a fenced ring
+// and selected with glBindBufferRange, so switching programs or passes uploads no matrices.
+// A slot is fenced when it stops being the bound one (another view, or the next beginFrame):
+// only then have all the draws that read it been issued. A reused slot is fenced again.
+// GL objects are created on first use (needs a current context).
+class FrameDataBuffer {
+public:
+    FrameDataBuffer() = default;
+    FrameDataBuffer(const FrameDataBuffer&) = delete;
+    FrameDataBuffer& operator=(const FrameDataBuffer&) = delete;
+
+    void shutdown();
+
+    // Frame-wide fields (viewport, time); forgets the views written last frame and fences
+    // the one still bound, since last frame's draws are all issued
+    void beginFrame(int fbw, int fbh, double seconds, float dt);
+
+    // Make vp the current view: uploaded the first time it is seen this frame, rebound after
+    void setView(const glm::mat4& vp);
+
+    const FrameDataBlock& current() const { return m_block; }
+
+private:
+    // The ring holds kViewsPerFrame views for kRingFrames frames before a write waits on the GPU
+    static constexpr size_t kViewsPerFrame = 16;
+    static constexpr size_t kRingFrames = 3;
+
+    struct View {
+        glm::mat4 vp;
+        size_t offset;
+    };
+
+    bool init();
+    void fenceBound(); // guard the bound slot: the draws reading it were issued
+
+    StreamBuffer m_stream;
+    size_t m_align = 256;           // slot stride, a multiple of GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT
+    FrameDataBlock m_block{};
+    unsigned long long m_frame = 0;
+    std::vector<View> m_views;      // written this frame
+    size_t m_bound = ~size_t(0);    // offset bound to kFrameDataBinding
+    bool m_boundFenced = false;     // m_bound was fenced and no draw has read it since
+};
+
+FrameDataBuffer& frameData();
@@ -0,0 +1,29 @@
+// include/gfx/FrameStats.hpp
+#pragma once
+#include <iosfwd>
+
+// What the current frame cost on the CPU -> GPU path. Filled by SpriteBatch, StaticSpriteBatch,
+// TriangleRenderer, Texture2D, ShaderProgram and the state cache; App::run calls beginFrameStats() per frame.
+struct FrameStats {
+    unsigned long long frame = 0;           // index of the frame being counted
+    unsigned long long drawCalls = 0;
+    unsigned long long sprites = 0;         // sprites drawn (streamed + static)
+    unsigned long long vertices = 0;        // 4 per sprite quad
+    unsigned long long uploadBytes = 0;     // vertex/instance/index data sent to buffers
+    unsigned long long textureBinds = 0;    // textures bound for draws
+    unsigned long long programBinds = 0;    // glUseProgram calls the state cache forwarded
+    unsigned long long droppedSprites = 0;  // lost to SpriteOverflow::Drop
+    unsigned long long overflows = 0;       // times a batch hit its capacity
+    unsigned long long textureUploads = 0;  // texture images created
+    unsigned long long textureBytes = 0;
+    unsigned long long shaderBuilds = 0;    // programs compiled + linked
+    unsigned long long skippedStateCalls = 0; // redundant binds/state/uniforms the state cache dropped
+};
+
+FrameStats& frameStats();   // the frame being recorded
+void beginFrameStats();     // zero the counters and advance frame
+
+// One record per line, for spreadsheets (CSV) or log tooling (JSON lines)
+void writeFrameStatsCsvHeader(std::ostream& os);
+void writeFrameStatsCsv(std::ostream& os, const FrameStats& s);
+void writeFrameStatsJson(std::ostream& os, const FrameStats& s);
@@ -4,6 +4,17 @@
 #include <glm/mat4x4.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
+// Axis-aligned world-space rectangle (min = bottom-left, max = top-right)
+struct Rect2D
+{
+    glm::vec2 min{ 0.0f }, max{ 0.0f };
+
+    bool overlaps(const Rect2D& o) const
+    {
+        return min.x <= o.max.x && max.x >= o.min.x && min.y <= o.max.y && max.y >= o.min.y;
+    }
+};
+
 class OrthoCamera2D 
 {
 public:
@@ -64,6 +75,18 @@ public:
         return { l + nx * (r - l), b + ny * (t - b) };
     }
 
+    // World-space area currently on screen (what vp() maps to the viewport)
+    Rect2D visibleRect() const
+    {
+        auto [l, r, b, t] = lrbt();
+        return { { l, b }, { r, t } };
+    }
+
+    bool isVisible(const Rect2D& bounds) const
+    {
+        return visibleRect().overlaps(bounds);
+    }
+
     // View-projection (world -> NDC)
     glm::mat4 vp() const 
     {
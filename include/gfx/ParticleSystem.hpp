@@ -0,0 +1,116 @@
+// include/gfx/ParticleSystem.hpp
+#pragma once
+#include <glad/glad.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+#include "gfx/Simd.hpp"
+#include "gfx/Sprite.hpp"
+
+class SpriteBatch;
+
+// Look and motion shared by every particle of one system (one system per effect)
+struct ParticleParams {
+    glm::vec2 gravity{ 0.0f };    // units/s^2
+    float drag = 0.0f;            // velocity decays by exp(-drag * seconds)
+    glm::vec4 colorStart{ 1.0f }; // color over life: start -> end
+    glm::vec4 colorEnd{ 1.0f, 1.0f, 1.0f, 0.0f };
+    float sizeStart = 1.0f;       // diameter over life: start -> end
+    float sizeEnd = 0.0f;
+    GLuint texture = 0;           // 0 = batch texture
+    glm::vec4 uv{ 0.0f, 0.0f, 1.0f, 1.0f };
+    SpriteShape shape = SpriteShape::Circle;
+    int layer = 0;
+};
+
+// One emit() call: count particles around pos, fired at angle +- spread
+struct ParticleBurst {
+    glm::vec2 pos{ 0.0f };
+    glm::vec2 jitter{ 0.0f };     // spawn inside pos +- jitter
+    glm::vec2 inherit{ 0.0f };    // velocity added to every particle (e.g. the emitter's)
+    float angle = 0.0f;           // radians
+    float spread = 3.14159265f;   // half angle; pi = all directions
+    float speedMin = 0.0f, speedMax = 1.0f;
+    float lifeMin = 0.5f, lifeMax = 1.0f; // seconds
+    int count = 1;
+};
+
+// Fixed-capacity particle pool in structure-of-arrays layout. update() runs one fused
+// SIMD pass (integrate, age, color/size ramp) over the live range, optionally split across
+// worker threads; dead particles are recycled by moving the last live one into their slot,
+// so the live range stays dense and the tail is the free list. render() hands the arrays to
+// SpriteBatch::pushPoints, which expands them without building Sprites.
+// Each array starts on a 64-byte line and spans a whole number of lines.
+class ParticleSystem {
+public:
+    ParticleSystem();
+    ~ParticleSystem(); // stops the worker threads
+    ParticleSystem(const ParticleSystem&) = delete; // m_s points into m_pool
+    ParticleSystem& operator=(const ParticleSystem&) = delete;
+
+    // Clamps maxSimd to what the CPU supports
+    void init(size_t capacity, const ParticleParams& params, SimdLevel maxSimd = SimdLevel::AVX2);
+
+    // Returns how many were spawned; a full pool drops the rest
+    int emit(const ParticleBurst& burst);
+
+    // workers > 1 splits the pass across that many threads (the caller is one of them),
+    // once each gets at least kMinPerWorker particles. The extra threads are started on
+    // first use and then sleep between steps, so a fixed step does not pay thread creation.
+    void update(float dt, int workers = 1);
+
+    void render(SpriteBatch& batch) const;
+    void clear() { m_count = 0; }
+
+    const ParticleParams& params() const { return m_params; }
+    void setParams(const ParticleParams& params) { m_params = params; }
+
+    size_t size() const { return m_count; }
+    size_t capacity() const { return m_capacity; }
+    SimdLevel simdLevel() const { return m_simd; }
+
+    static constexpr size_t kMinPerWorker = 16384;
+
+    // Pointers into the pool, one array per field
+    struct Streams {
+        float* x;  float* y;
+        float* vx; float* vy;
+        float* t;     // normalized age 0..1; dead at 1
+        float* rate;  // 1 / lifetime
+        float* size;
+        float* r; float* g; float* b; float* a;
+    };
+    // Per-step constants of the update kernels
+    struct Step {
+        float dt;
+        float gx, gy;   // gravity * dt
+        float damp;     // velocity scale for this step
+        float size0, sizeD;
+        glm::vec4 color0, colorD;
+    };
+
+private:
+    static constexpr size_t kStreams = 11;
+    struct Workers; // persistent thread pool (ParticleSystem.cpp)
+
+    void compact();
+    float random01();
+
+    ParticleParams m_params;
+    SimdLevel m_simd = SimdLevel::Scalar;
+    void (*m_kernel)(const Step&, const Streams&, size_t, size_t) = nullptr;
+
+    static constexpr size_t kLineFloats = 16; // 64-byte cache line
+
+    std::vector<float> m_pool;  // kStreams arrays of m_stride floats, plus slack to align them
+    float* m_base = nullptr;    // first line boundary in m_pool
+    Streams m_s{};
+    size_t m_capacity = 0;
+    size_t m_stride = 0;        // m_capacity rounded up to whole lines
+    size_t m_count = 0;
+    std::uint32_t m_rng = 0x9E3779B9u;
+    std::unique_ptr<Workers> m_workers;
+};
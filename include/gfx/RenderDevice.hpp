@@ -0,0 +1,241 @@
+// include/gfx/RenderDevice.hpp
+#pragma once
+#include <glad/glad.h>
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Thin seam between the gfx classes (SpriteBatch, StreamBuffer, Texture2D, ShaderProgram,
+// TriangleRenderer, ...) and OpenGL. Methods mirror the GL entry points 1:1 minus the "gl"
+// prefix, so call sites read like plain GL. The active device is process-wide:
+//   GL (default)    forwards to glad
+//   NullRenderDevice    discards everything, hands out fake ids: no context or GPU needed
+//   RecordingRenderDevice   null + counts calls/bytes, for microbenchmarks on headless CI
+// device() puts a CachingRenderDevice in front of it that drops redundant state calls.
+class RenderDevice {
+public:
+    virtual ~RenderDevice() = default;
+
+    // Buffers
+    virtual void genBuffers(GLsizei n, GLuint* ids) = 0;
+    virtual void deleteBuffers(GLsizei n, const GLuint* ids) = 0;
+    virtual void bindBuffer(GLenum target, GLuint id) = 0;
+    virtual void bufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage) = 0;
+    virtual void bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data) = 0;
+    virtual void* mapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access) = 0;
+    virtual GLboolean unmapBuffer(GLenum target) = 0;
+    virtual void bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size) = 0;
+
+    // Sync
+    virtual GLsync fenceSync(GLenum condition, GLbitfield flags) = 0;
+    virtual GLenum clientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout) = 0;
+    virtual void deleteSync(GLsync sync) = 0;
+
+    // Vertex arrays
+    virtual void genVertexArrays(GLsizei n, GLuint* ids) = 0;
+    virtual void deleteVertexArrays(GLsizei n, const GLuint* ids) = 0;
+    virtual void bindVertexArray(GLuint id) = 0;
+    virtual void enableVertexAttribArray(GLuint index) = 0;
+    virtual void vertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* offset) = 0;
+    virtual void vertexAttribIPointer(GLuint index, GLint size, GLenum type, GLsizei stride, const void* offset) = 0;
+    virtual void vertexAttribDivisor(GLuint index, GLuint divisor) = 0;
+
+    // Textures
+    virtual void genTextures(GLsizei n, GLuint* ids) = 0;
+    virtual void deleteTextures(GLsizei n, const GLuint* ids) = 0;
+    virtual void bindTexture(GLenum target, GLuint id) = 0;
+    virtual void activeTexture(GLenum unit) = 0;
+    virtual void texParameteri(GLenum target, GLenum name, GLint value) = 0;
+    virtual void texImage2D(GLenum target, GLint level, GLint internalFormat, GLsizei w, GLsizei h,
+        GLint border, GLenum format, GLenum type, const void* pixels) = 0;
+    virtual void generateMipmap(GLenum target) = 0;
+    virtual void pixelStorei(GLenum name, GLint value) = 0;
+    virtual void texBuffer(GLenum target, GLenum internalFormat, GLuint buffer) = 0;
+
+    // Framebuffers
+    virtual void genFramebuffers(GLsizei n, GLuint* ids) = 0;
+    virtual void deleteFramebuffers(GLsizei n, const GLuint* ids) = 0;
+    virtual void bindFramebuffer(GLenum target, GLuint id) = 0;
+    virtual void framebufferTexture2D(GLenum target, GLenum attachment, GLenum texTarget, GLuint tex, GLint level) = 0;
+    virtual GLenum checkFramebufferStatus(GLenum target) = 0;
+    virtual void genRenderbuffers(GLsizei n, GLuint* ids) = 0;
+    virtual void deleteRenderbuffers(GLsizei n, const GLuint* ids) = 0;
+    virtual void bindRenderbuffer(GLenum target, GLuint id) = 0;
+    virtual void renderbufferStorage(GLenum target, GLenum internalFormat, GLsizei w, GLsizei h) = 0;
+    virtual void framebufferRenderbuffer(GLenum target, GLenum attachment, GLenum rbTarget, GLuint rb) = 0;
+
+    // Shaders
+    virtual GLuint createShader(GLenum type) = 0;
+    virtual void shaderSource(GLuint shader, GLsizei count, const GLchar* const* src, const GLint* len) = 0;
+    virtual void compileShader(GLuint shader) = 0;
+    virtual void getShaderiv(GLuint shader, GLenum name, GLint* out) = 0;
+    virtual void getShaderInfoLog(GLuint shader, GLsizei max, GLsizei* len, GLchar* log) = 0;
+    virtual void deleteShader(GLuint shader) = 0;
+    virtual GLuint createProgram() = 0;
+    virtual void attachShader(GLuint prog, GLuint shader) = 0;
+    virtual void linkProgram(GLuint prog) = 0;
+    virtual void getProgramiv(GLuint prog, GLenum name, GLint* out) = 0;
+    virtual void getProgramInfoLog(GLuint prog, GLsizei max, GLsizei* len, GLchar* log) = 0;
+    virtual void deleteProgram(GLuint prog) = 0;
+    virtual void useProgram(GLuint prog) = 0;
+    virtual GLint getUniformLocation(GLuint prog, const GLchar* name) = 0;
+    virtual void uniform1i(GLint loc, GLint v) = 0;
+    virtual void uniform1iv(GLint loc, GLsizei count, const GLint* v) = 0;
+    virtual void uniformMatrix4fv(GLint loc, GLsizei count, GLboolean transpose, const GLfloat* m) = 0;
+    virtual GLuint getUniformBlockIndex(GLuint prog, const GLchar* name) = 0;
+    virtual void uniformBlockBinding(GLuint prog, GLuint block, GLuint binding) = 0;
+
+    // Fixed-function state
+    virtual void enable(GLenum cap) = 0;
+    virtual void disable(GLenum cap) = 0;
+    virtual void blendFunc(GLenum src, GLenum dst) = 0;
+    virtual void blendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcA, GLenum dstA) = 0;
+    virtual void depthFunc(GLenum func) = 0;
+    virtual void depthMask(GLboolean flag) = 0;
+    virtual void clear(GLbitfield mask) = 0;
+    virtual void clearColor(GLfloat r, GLfloat g, GLfloat b, GLfloat a) = 0;
+    virtual void viewport(GLint x, GLint y, GLsizei w, GLsizei h) = 0;
+
+    // Draws
+    virtual void drawElements(GLenum mode, GLsizei count, GLenum type, const void* indices) = 0;
+    virtual void drawElementsBaseVertex(GLenum mode, GLsizei count, GLenum type, const void* indices, GLint baseVertex) = 0;
+    virtual void drawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instances) = 0;
+
+    // Queries
+    virtual void getIntegerv(GLenum name, GLint* out) = 0;
+    virtual void getFloatv(GLenum name, GLfloat* out) = 0;
+    virtual GLboolean isEnabled(GLenum cap) = 0;
+};
+
+// Discards every call. Ids are unique and non-zero, shaders always compile, mapped ranges
+// point at host scratch memory, so the CPU side of the callers runs exactly as with GL.
+class NullRenderDevice : public RenderDevice {
+public:
+    void genBuffers(GLsizei n, GLuint* ids) override { genIds(OpKind::Create, n, ids); }
+    void deleteBuffers(GLsizei, const GLuint*) override { count(OpKind::Create); }
+    void bindBuffer(GLenum, GLuint) override { count(OpKind::Bind); }
+    void bufferData(GLenum, GLsizeiptr size, const void* data, GLenum) override;
+    void bufferSubData(GLenum, GLintptr, GLsizeiptr size, const void*) override;
+    void* mapBufferRange(GLenum, GLintptr, GLsizeiptr length, GLbitfield) override;
+    GLboolean unmapBuffer(GLenum) override { count(OpKind::Other); return GL_TRUE; }
+    void bindBufferRange(GLenum, GLuint, GLuint, GLintptr, GLsizeiptr) override { count(OpKind::Bind); }
+
+    GLsync fenceSync(GLenum, GLbitfield) override;
+    GLenum clientWaitSync(GLsync, GLbitfield, GLuint64) override { count(OpKind::Sync); return GL_ALREADY_SIGNALED; }
+    void deleteSync(GLsync) override { count(OpKind::Sync); }
+
+    void genVertexArrays(GLsizei n, GLuint* ids) override { genIds(OpKind::Create, n, ids); }
+    void deleteVertexArrays(GLsizei, const GLuint*) override { count(OpKind::Create); }
+    void bindVertexArray(GLuint) override { count(OpKind::Bind); }
+    void enableVertexAttribArray(GLuint) override { count(OpKind::Other); }
+    void vertexAttribPointer(GLuint, GLint, GLenum, GLboolean, GLsizei, const void*) override { count(OpKind::Other); }
+    void vertexAttribIPointer(GLuint, GLint, GLenum, GLsizei, const void*) override { count(OpKind::Other); }
+    void vertexAttribDivisor(GLuint, GLuint) override { count(OpKind::Other); }
+
+    void genTextures(GLsizei n, GLuint* ids) override { genIds(OpKind::Create, n, ids); }
+    void deleteTextures(GLsizei, const GLuint*) override { count(OpKind::Create); }
+    void bindTexture(GLenum, GLuint) override { count(OpKind::Bind); }
+    void activeTexture(GLenum) override { count(OpKind::Bind); }
+    void texParameteri(GLenum, GLenum, GLint) override { count(OpKind::Other); }
+    void texImage2D(GLenum, GLint, GLint, GLsizei w, GLsizei h, GLint, GLenum format, GLenum, const void*) override;
+    void generateMipmap(GLenum) override { count(OpKind::Other); }
+    void pixelStorei(GLenum, GLint) override { count(OpKind::Other); }
+    void texBuffer(GLenum, GLenum, GLuint) override { count(OpKind::Other); }
+
+    void genFramebuffers(GLsizei n, GLuint* ids) override { genIds(OpKind::Create, n, ids); }
+    void deleteFramebuffers(GLsizei, const GLuint*) override { count(OpKind::Create); }
+    void bindFramebuffer(GLenum, GLuint) override { count(OpKind::Bind); }
+    void framebufferTexture2D(GLenum, GLenum, GLenum, GLuint, GLint) override { count(OpKind::Other); }
+    GLenum checkFramebufferStatus(GLenum) override { count(OpKind::Query); return GL_FRAMEBUFFER_COMPLETE; }
+    void genRenderbuffers(GLsizei n, GLuint* ids) override { genIds(OpKind::Create, n, ids); }
+    void deleteRenderbuffers(GLsizei, const GLuint*) override { count(OpKind::Create); }
+    void bindRenderbuffer(GLenum, GLuint) override { count(OpKind::Bind); }
+    void renderbufferStorage(GLenum, GLenum, GLsizei, GLsizei) override { count(OpKind::Other); }
+    void framebufferRenderbuffer(GLenum, GLenum, GLenum, GLuint) override { count(OpKind::Other); }
+
+    GLuint createShader(GLenum) override { return nextId(OpKind::Create); }
+    void shaderSource(GLuint, GLsizei, const GLchar* const*, const GLint*) override { count(OpKind::Other); }
+    void compileShader(GLuint) override { count(OpKind::Other); }
+    void getShaderiv(GLuint, GLenum name, GLint* out) override { count(OpKind::Query); *out = statusValue(name); }
+    void getShaderInfoLog(GLuint, GLsizei max, GLsizei* len, GLchar* log) override;
+    void deleteShader(GLuint) override { count(OpKind::Create); }
+    GLuint createProgram() override { return nextId(OpKind::Create); }
+    void attachShader(GLuint, GLuint) override { count(OpKind::Other); }
+    void linkProgram(GLuint) override { count(OpKind::Other); }
+    void getProgramiv(GLuint, GLenum name, GLint* out) override { count(OpKind::Query); *out = statusValue(name); }
+    void getProgramInfoLog(GLuint, GLsizei max, GLsizei* len, GLchar* log) override;
+    void deleteProgram(GLuint) override { count(OpKind::Create); }
+    void useProgram(GLuint) override { count(OpKind::Bind); }
+    GLint getUniformLocation(GLuint, const GLchar* name) override { count(OpKind::Query); return nameSlot(name); }
+    void uniform1i(GLint, GLint) override { count(OpKind::Uniform); }
+    void uniform1iv(GLint, GLsizei, const GLint*) override { count(OpKind::Uniform); }
+    void uniformMatrix4fv(GLint, GLsizei, GLboolean, const GLfloat*) override { count(OpKind::Uniform); }
+    GLuint getUniformBlockIndex(GLuint, const GLchar* name) override { count(OpKind::Query); return static_cast<GLuint>(nameSlot(name)); }
+    void uniformBlockBinding(GLuint, GLuint, GLuint) override { count(OpKind::Other); }
+
+    void enable(GLenum) override { count(OpKind::Other); }
+    void disable(GLenum) override { count(OpKind::Other); }
+    void blendFunc(GLenum, GLenum) override { count(OpKind::Other); }
+    void blendFuncSeparate(GLenum, GLenum, GLenum, GLenum) override { count(OpKind::Other); }
+    void depthFunc(GLenum) override { count(OpKind::Other); }
+    void depthMask(GLboolean) override { count(OpKind::Other); }
+    void clear(GLbitfield) override { count(OpKind::Other); }
+    void clearColor(GLfloat, GLfloat, GLfloat, GLfloat) override { count(OpKind::Other); }
+    void viewport(GLint, GLint, GLsizei, GLsizei) override { count(OpKind::Other); }
+
+    void drawElements(GLenum, GLsizei, GLenum, const void*) override { count(OpKind::Draw); }
+    void drawElementsBaseVertex(GLenum, GLsizei, GLenum, const void*, GLint) override { count(OpKind::Draw); }
+    void drawArraysInstanced(GLenum, GLint, GLsizei, GLsizei) override { count(OpKind::Draw); }
+
+    void getIntegerv(GLenum name, GLint* out) override;
+    void getFloatv(GLenum name, GLfloat* out) override;
+    GLboolean isEnabled(GLenum) override { count(OpKind::Query); return GL_FALSE; } // GL's initial state
+
+protected:
+    enum class OpKind { Create, Bind, BufferUpload, TextureUpload, Sync, Uniform, Draw, Query, Other };
+    virtual void count(OpKind, size_t /*bytes*/ = 0) {}
+
+private:
+    GLuint nextId(OpKind kind) { count(kind); return ++m_lastId; }
+    void genIds(OpKind kind, GLsizei n, GLuint* ids);
+    static GLint statusValue(GLenum name);
+    GLint nameSlot(const GLchar* name); // "found"; one location per name, shared by all programs
+
+    GLuint m_lastId = 0;
+    std::unordered_map<std::string, GLint> m_nameSlots; // uniform / block name -> location
+    std::vector<unsigned char> m_mapScratch; // what mapBufferRange hands out
+};
+
+// Null device that tallies what the callers asked for
+struct DeviceStats {
+    unsigned long long calls = 0;         // every entry point
+    unsigned long long draws = 0;
+    unsigned long long binds = 0;         // bind*, activeTexture, useProgram
+    unsigned long long uniforms = 0;
+    unsigned long long syncs = 0;         // fence create/wait/delete
+    unsigned long long creates = 0;       // gen/create/delete of GL objects
+    unsigned long long bufferBytes = 0;   // bufferData/bufferSubData with data + mapped ranges
+    unsigned long long textureBytes = 0;  // texImage2D uploads
+};
+
+class RecordingRenderDevice : public NullRenderDevice {
+public:
+    const DeviceStats& stats() const { return m_stats; }
+    void resetStats() { m_stats = {}; }
+
+protected:
+    void count(OpKind kind, size_t bytes) override;
+
+private:
+    DeviceStats m_stats;
+};
+
+// Active device (the GL one unless replaced), always behind the state cache; with caching off
+// the cache forwards every call but still counts FrameStats::programBinds.
+// setRenderDevice(nullptr) restores GL. Not synchronized: switch devices only while no gfx
+// object is in use.
+RenderDevice& device();
+void setRenderDevice(RenderDevice* dev);
+void setStateCaching(bool on);   // off: every call reaches the device (A/B, debugging)
+void invalidateStateCache();     // after GL state was changed without going through device()
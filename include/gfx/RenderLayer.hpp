@@ -0,0 +1,57 @@
+// include/gfx/RenderLayer.hpp
+#pragma once
+#include <glad/glad.h>
+#include <glm/mat4x4.hpp>
+#include "gfx/OrthoCamera2D.hpp"
+#include "gfx/Sprite.hpp"
+
+// Offscreen color texture (+ depth, for SpriteBatch's opaque pass) that caches a group of
+// draws. Capture once, then composite it as one sprite with sample mode kSampleMode until
+// invalidate() or a different view. While capturing, color is accumulated premultiplied
+// (see beginCapture), which is what kSampleMode expects.
+//
+//   if (layer.needsCapture(vp)) { layer.beginCapture(vp); ...draw...; layer.endCapture(fbw, fbh); }
+//   batch.setSampleMode(RenderLayer::kSampleMode); batch.push(layer.sprite(cam.visibleRect()));
+class RenderLayer {
+public:
+    static constexpr int kSampleMode = 3; // sprite_batch.frag: premultiplied texture
+
+    RenderLayer() = default;
+    ~RenderLayer() { shutdown(); }
+    RenderLayer(const RenderLayer&) = delete;
+    RenderLayer& operator=(const RenderLayer&) = delete;
+
+    // (Re)creates the targets if the size changed; a new size needs a new capture
+    bool resize(int width, int height);
+    void shutdown();
+
+    void invalidate() { m_dirty = true; }
+    // Contents missing, invalidated, or captured under a different view-projection
+    bool needsCapture(const glm::mat4& vp) const { return m_dirty || vp != m_vp; }
+
+    // Redirect drawing into the layer: binds the FBO, sets the viewport to the layer size,
+    // clears to transparent (the caller's clear color is saved) and blends with (SRC_ALPHA, 1 - SRC_ALPHA) for color but
+    // (1, 1 - SRC_ALPHA) for alpha, so the texture ends up premultiplied.
+    void beginCapture(const glm::mat4& vp);
+    // Back to the default framebuffer (viewport fbw x fbh, normal blending, the clear color
+    // from before beginCapture); layer is clean
+    void endCapture(int fbw, int fbh);
+
+    // Quad that shows the layer over rect (normally the camera's visibleRect at capture)
+    Sprite sprite(const Rect2D& rect) const;
+
+    GLuint texture() const { return m_tex; }
+    int width() const { return m_w; }
+    int height() const { return m_h; }
+    unsigned long long captureCount() const { return m_captures; }
+
+private:
+    GLuint m_fbo = 0;
+    GLuint m_tex = 0;
+    GLuint m_depth = 0;   // renderbuffer
+    int m_w = 0, m_h = 0;
+    bool m_dirty = true;
+    glm::mat4 m_vp{ 0.0f };
+    GLfloat m_prevClear[4] = {}; // clear color to put back in endCapture
+    unsigned long long m_captures = 0;
+};
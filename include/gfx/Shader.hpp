@@ -1,6 +1,8 @@
 #pragma once
 #include <glad/glad.h>
 #include <string>
+#include <unordered_map>
+#include "gfx/RenderDevice.hpp"
 
 class ShaderProgram {
 public:
@@ -9,9 +11,11 @@ public:
 
     // Compile + link from GLSL files
     bool loadFromFiles(const char* vsPath, const char* fsPath);
+    // Same, with extra lines (e.g. "#define SPRITE_INSTANCED\n") inserted after #version in both stages
+    bool loadFromFiles(const char* vsPath, const char* fsPath, const char* defines);
 
     // Bind program
-    void use() const { glUseProgram(m_id); }
+    void use() const { device().useProgram(m_id); }
 
     // Get raw program id (optional)
     GLuint id() const { return m_id; }
@@ -19,19 +23,19 @@ public:
     // Free GL objects if any
     void destroy();
 
-    // Optional: uniform location helper
-    GLint uniformLocation(const char* name) const {
-        return glGetUniformLocation(m_id, name);
-    }
+    // Optional: uniform location helper (queried once per name, then cached)
+    GLint uniformLocation(const char* name) const;
     void setMat4(const char* name, const float* m) const {
-        const GLint loc = glGetUniformLocation(m_id, name);
-        if (loc != -1) glUniformMatrix4fv(loc, 1, GL_FALSE, m);
+        const GLint loc = uniformLocation(name);
+        if (loc != -1) device().uniformMatrix4fv(loc, 1, GL_FALSE, m);
     }
 
 private:
     GLuint m_id = 0;
+    mutable std::unordered_map<std::string, GLint> m_locations; // -1 entries too
 
     static bool readTextFile(const char* path, std::string& out);
+    static void injectDefines(std::string& src, const char* defines);
     static bool compile(GLenum type, const std::string& src, GLuint& outShader, std::string& log);
     static bool link(GLuint prog, GLuint vs, GLuint fs, std::string& log);
 };
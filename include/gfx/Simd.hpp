@@ -0,0 +1,33 @@
+// include/gfx/Simd.hpp
+#pragma once
+
+// Instruction-set tiers for the hot CPU kernels (sprite expansion, particles, ...).
+// Each tier implies the ones below it; AVX2 here also means F16C and SSE4.1.
+enum class SimdLevel {
+    Scalar,
+    SSE2,
+    AVX2
+};
+
+// What this CPU (and OS, for AVX state) supports; detected once, then cached
+SimdLevel cpuSimdLevel();
+
+// min(requested, cpuSimdLevel()) - lets options cap the tier for benchmarking
+SimdLevel resolveSimdLevel(SimdLevel requested);
+
+const char* simdLevelName(SimdLevel level);
+
+// Compile-time gates for the x86 kernels. GCC/Clang need per-function target
+// attributes to emit AVX2 without raising the whole build's baseline; MSVC does not.
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define GFX_SIMD_X86 1
+#if defined(__GNUC__) || defined(__clang__)
+#define GFX_TARGET_SSE2 __attribute__((target("sse2")))
+#define GFX_TARGET_AVX2 __attribute__((target("avx2,f16c,sse4.1")))
+#else
+#define GFX_TARGET_SSE2
+#define GFX_TARGET_AVX2
+#endif
+#else
+#define GFX_SIMD_X86 0
+#endif
@@ -0,0 +1,92 @@
+// include/gfx/Sprite.hpp
+#pragma once
+#include <glad/glad.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+
+// Analytic outline of a sprite, evaluated per pixel in sprite_batch.frag as a signed distance
+// (antialiased edges, still one quad in the same batch as everything else)
+enum class SpriteShape : std::uint8_t {
+    Quad,         // plain rectangle, no distance evaluation
+    RoundedRect,  // corners rounded by cornerRadius
+    Circle,       // radius = half the shorter side (a capsule if the sprite is not square)
+};
+
+struct Sprite {
+    glm::vec2 pos;     // bottom-left in pixels
+    glm::vec2 size;    // width/height in pixels
+    glm::vec4 uv;      // (u0, v0, u1, v1) in 0..1
+    glm::vec4 color;   // RGBA (0..1)
+    GLuint texture = 0; // 0 = batch texture (setTexture)
+    int   layer = 0;   // sorted modes: lower layers draw first
+    float depth = 0.0f; // sorted modes: within a layer, lower depth draws first (further back)
+    float rotation = 0.0f;   // radians, counter-clockwise around pivot
+    glm::vec2 pivot{ 0.0f }; // rotation origin as a fraction of size (0.5, 0.5 = center), 0..1
+    SpriteShape shape = SpriteShape::Quad;
+    float cornerRadius = 0.0f; // RoundedRect, in the units of size (clamped to half the shorter side)
+    float borderWidth = 0.0f;  // > 0: only an outline this wide (units of size), inside the edge
+    float softness = 1.0f;     // width of the antialiased edge in screen pixels (0..15)
+};
+
+// Shape word, in SpriteInstance::shape or (vertex paths) the draw's shape table: bits 0-7 corner radius and 8-15 border width as
+// fractions of half the shorter side, 16-23 softness in 1/16 screen pixels, 24-31 SpriteShape.
+// Quad packs to 0, which the shaders skip. The second form takes the size separately (points).
+inline std::uint32_t packSpriteShape(const Sprite& s, glm::vec2 size) {
+    if (s.shape == SpriteShape::Quad) return 0;
+    const float half = 0.5f * std::min(std::abs(size.x), std::abs(size.y));
+    auto frac = [half](float px) {
+        const float f = half > 0.0f ? px / half : 0.0f;
+        return static_cast<std::uint32_t>(std::clamp(f, 0.0f, 1.0f) * 255.0f + 0.5f);
+    };
+    const std::uint32_t radius = (s.shape == SpriteShape::Circle) ? 255u : frac(s.cornerRadius);
+    const std::uint32_t soft = static_cast<std::uint32_t>(std::clamp(s.softness, 0.0f, 15.9f) * 16.0f + 0.5f);
+    return radius | frac(s.borderWidth) << 8 | soft << 16 | std::uint32_t(s.shape) << 24;
+}
+inline std::uint32_t packSpriteShape(const Sprite& s) { return packSpriteShape(s, s.size); }
+
+// Squares in structure-of-arrays form (ParticleSystem's pool): point i is centered on
+// (x[i], y[i]), size[i] wide and tall, colored (r, g, b, a)[i]. Everything else (uv,
+// texture, shape, layer) comes from one template Sprite; no rotation.
+struct SpritePoints {
+    const float* x; const float* y;
+    const float* size;
+    const float* r; const float* g; const float* b; const float* a;
+};
+
+// GPU records written by SpriteBatch (one layout per SpriteSubmit mode)
+
+// Vertices path: 36 bytes per corner
+struct SpriteVertex {
+    float x, y;    // position in pixels
+    float u, v;    // uv
+    float r, g, b, a; // color
+    // bits 0-3: texture slot, 4-7: sample mode, 8-13: shape (index into the draw's table of
+    // packSpriteShape words, 0 = Quad), 14-31: opaque-pass depth (0 = none)
+    std::uint32_t flags;
+};
+
+// PackedVertices path: 16 bytes per corner
+struct SpritePackedVertex {
+    std::uint32_t xy;        // half2 position
+    std::uint32_t uv;        // unorm16x2
+    std::uint32_t rgba;      // RGBA8 normalized
+    std::uint32_t flags;     // same bits as SpriteVertex::flags
+};
+
+// Instanced path: 48 bytes per sprite instead of 4 * 36 (+ 24 bytes of indices).
+// The shape word is in the record, so the flags' shape index stays 0.
+// The uv rect is unorm16 like the packed path (textures clamp to the edge anyway).
+struct SpriteInstance {
+    float x, y, w, h;        // bottom-left + size
+    std::uint32_t uv0;       // unorm16x2 (u0, v0)
+    std::uint32_t uv1;       // unorm16x2 (u1, v1)
+    std::uint32_t rgba;      // color, RGBA8 normalized
+    std::uint32_t flags;     // same bits as SpriteVertex::flags (shape index unused)
+    float rotation;          // radians; the vertex shader rotates the corners
+    std::uint32_t pivot;     // unorm16x2 fraction of size
+    std::uint32_t shape;     // packSpriteShape
+    std::uint32_t reserved;  // keeps the record 3 RGBA32UI texels (Pulled)
+};
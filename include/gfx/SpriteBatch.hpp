@@ -1,23 +1,100 @@
 // include/gfx/SpriteBatch.hpp
 #pragma once
 #include <glad/glad.h>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <unordered_set>
 #include <vector>
 #include <glm/vec2.hpp>
 #include <glm/vec4.hpp>
 #include "gfx/Shader.hpp"
+#include "gfx/Sprite.hpp"
+#include "gfx/SpriteKernels.hpp"
+#include "gfx/SpriteRecorder.hpp"
+#include "gfx/StreamBuffer.hpp"
 #include <glm/mat4x4.hpp> 
 
-struct Sprite {
-    glm::vec2 pos;     // bottom-left in pixels
-    glm::vec2 size;    // width/height in pixels
-    glm::vec4 uv;      // (u0, v0, u1, v1) in 0..1
-    glm::vec4 color;   // RGBA (0..1)
+// How queued sprites reach the vertex shader
+enum class SpriteSubmit {
+    Vertices,       // 4 expanded vertices per sprite + shared index buffer
+    PackedVertices, // same, 16-byte vertices: half-float pos, unorm16 uv, RGBA8 color.
+                    // Half pos is exact for integer pixels up to 2048; world units lose precision far from 0.
+                    // UVs are clamped to 0..1.
+    Instanced,      // one compact record per sprite, quad expanded in sprite_batch.vert
+    Pulled          // same records, read through a GL_TEXTURE_BUFFER view of the ring with
+                    // texelFetch(gl_VertexID / 4): no vertex attributes at all
 };
 
+// Index table for the indexed paths (Instanced needs none: corners come from gl_VertexID)
+enum class SpriteIndexType {
+    U16,  // half the index bytes; capped at 16384 quads, longer runs draw in base-vertex chunks
+    U32   // one table covering the whole capacity, one draw per flush
+};
+
+// Draw order. The sorted modes defer expansion to endAndDraw and radix-sort a 64-bit key
+// per sprite: layer(16) | unused(4) | texture(20) | depth(24). There is no sample-mode (shader)
+// field: every mode runs in the one program and travels in the sprite's flags, so mixed
+// modes never split a draw and grouping by them would only reorder sprites for nothing.
+enum class SpriteSort {
+    None,    // draw in push() order (immediate expansion)
+    ByKey,   // group by layer, then texture and depth: fewest slot changes
+    ByLayer  // only layers reorder; push order is kept within a layer (safe for overlapping blends)
+};
+
+// What push() does once maxSprites are queued
+enum class SpriteOverflow {
+    Drop,   // discard the sprite (counted in droppedCount())
+    Flush,  // draw what is queued, continue in the next ring region
+    Grow    // double CPU + GPU capacity (up to growLimit, then Flush)
+};
+
+struct SpriteBatchOptions {
+    int maxSprites = 2000;      // sprites per flush (initial capacity with Grow)
+    // Vertex buffer is a ring holding this many full flushes, so each flush
+    // writes where the GPU is not reading. Raise it if streamStats().stalls keeps growing.
+    int ringFlushes = 3;
+    StreamMode stream = StreamMode::Unsynchronized;
+    SpriteSubmit submit = SpriteSubmit::Vertices;
+    SpriteIndexType indices = SpriteIndexType::U16;
+    SpriteOverflow overflow = SpriteOverflow::Flush;
+    int growLimit = 1 << 20;
+    // Draw opaque sprites (opaque texture, color alpha 1, sample mode 0, Quad shape) first, front-to-back
+    // with depth writes and no blending, then the rest back-to-front, depth-tested, so hidden
+    // pixels are rejected before shading. Order is the usual one (push order or the sort);
+    // defers like the sorted modes and needs a depth buffer. Mark textures with setTextureOpaque.
+    // Blend and depth-test enables are put back as they were; the depth mask is left on and
+    // the depth func GL_LESS.
+    bool opaquePass = false;
+    // Distinct textures per draw (one texture unit each); the batch only breaks
+    // when a sprite needs one more. Clamped to GL_MAX_TEXTURE_IMAGE_UNITS and 16.
+    int maxTextures = 8;
+    SpriteSort sort = SpriteSort::None;
+    // Highest kernel tier for push/pushMany; the CPU is checked at init and wins if lower
+    SimdLevel maxSimd = SimdLevel::AVX2;
+};
+
+class StaticSpriteBatch;
+
 class SpriteBatch {
 public:
+    static constexpr int kMaxTextureSlots = 16;
+    // Vertex paths: distinct non-Quad shape words per draw (u_Shapes, flags bits 8-13);
+    // entry 0 is the plain quad. Instanced/Pulled records carry the word themselves.
+    static constexpr int kMaxShapes = 64;
+    // pushRecorded uses another thread only once each gets at least this many sprites
+    static constexpr size_t kMinRecordedPerWorker = 4096;
+
+    SpriteBatch();
+    ~SpriteBatch(); // stops the pushRecorded threads (GL objects still need shutdown())
+    SpriteBatch(const SpriteBatch&) = delete;
+    SpriteBatch& operator=(const SpriteBatch&) = delete;
+
     bool init(const char* vsPath, const char* fsPath, const char* texturePath,
         int maxSprites = 2000);
+    bool init(const char* vsPath, const char* fsPath, const char* texturePath,
+        const SpriteBatchOptions& opt);
     void shutdown();
 
     // Begin a new frame; provide framebuffer size (for ortho)
@@ -25,39 +102,172 @@ public:
 
     // Queue sprites (CPU only). You can call this many times per frame.
     void push(const Sprite& s);
+    // Bulk version: expands whole runs with the SIMD kernels straight into the staging buffer
+    void pushMany(std::span<const Sprite> sprites);
+    // n squares from structure-of-arrays data (see SpritePoints), the rest of each from tmpl.
+    // Written straight into the staging buffer; the sorted modes build Sprites for the sort.
+    void pushPoints(const SpritePoints& points, size_t n, const Sprite& tmpl);
+    // Merge recorders filled on other threads, in span order (deterministic regardless of
+    // which worker finished first). Call from the render thread once the workers are done.
+    // When everything fits in the current flush (capacity, texture slots, shape table), each
+    // recorder expands into its own range at its prefix offset, split across up to `workers`
+    // threads (the caller is one; started on first use, then sleeping between calls).
+    // Otherwise, and in the deferred modes, the recorders are merged one after another.
+    void pushRecorded(std::span<const SpriteRecorder> recorders, int workers = 1);
 
-    // Upload CPU data to GPU and issue ONE draw call
+    // Upload CPU data to GPU and issue ONE draw call (more if the batch overflowed with Flush,
+    // and one per texture-slot run when more textures are used than there are units)
     void endAndDraw();
+    // Draw what is queued so far, keeping submission order before another renderer draws
+    // with its own program (TileMapRenderer); the next flush switches back to the batch's
+    void submitQueued();
+
+    // Retained geometry: expand sprites once into out's static buffers (texture 0 resolves to
+    // the current setTexture(), the sample mode is the current setSampleMode()). drawStatic draws
+    // it in submission order with the current VP, after whatever was queued before it.
+    bool buildStatic(StaticSpriteBatch& out, std::span<const Sprite> sprites);
+    void drawStatic(const StaticSpriteBatch& sb);
+
+    // Draw the most recent flush again from the data already in the ring, with the current
+    // program/VP (e.g. a shadow pass, then beginWithVP + redrawLast for the main
+    // one). False if there is nothing to redraw (nothing flushed yet, or the ring was resized).
+    bool redrawLast();
 
     // Convenience
-    void setTexture(GLuint tex); // if you want to swap texture later
+    void setTexture(GLuint tex); // texture for sprites with Sprite::texture == 0
     void beginWithVP(const glm::mat4& VP);
-    void setSampleMode(int mode); // 0 = normal, 1 = font mask
+    // 0 = normal, 1 = font mask, 2 = alpha, 3 = RenderLayer. Recorded into each sprite pushed
+    // after it (flags bits 4-7), so sprites of different modes share one draw and keep their order.
+    void setSampleMode(int mode);
+    // opaquePass: textures without translucent texels (the batch texture is checked on load)
+    void setTextureOpaque(GLuint tex, bool opaque);
     GLuint texture() const { return m_tex; }
+    int sampleMode() const { return m_mode; }
+    SpriteSubmit submitMode() const { return m_opt.submit; }
+    SimdLevel simdLevel() const { return m_simd; }
+
+    // Ring upload counters (wraps/stalls) to size SpriteBatchOptions::ringFlushes
+    const StreamStats& streamStats() const { return m_stream.stats(); }
+    void resetStreamStats() { m_stream.resetStats(); }
+
+    // Overflow counters: times push() hit capacity, sprites lost (Drop), capacity doublings (Grow)
+    unsigned long long overflowCount() const { return m_overflows; }
+    unsigned long long droppedCount() const { return m_dropped; }
+    unsigned long long growCount() const { return m_grows; }
+    unsigned long long textureBreakCount() const { return m_textureBreaks; } // flushes forced by full slots or shape tables
+    int capacity() const { return m_maxSprites; }
 
 private:
-    struct Vertex {
-        float x, y;    // position in pixels
-        float u, v;    // uv
-        float r, g, b, a; // color
+    using Vertex = SpriteVertex;
+    using PackedVertex = SpritePackedVertex;
+    using Instance = SpriteInstance;
+
+    // One flushed ring region, kept so redrawLast() can replay it
+    struct StreamedDraw {
+        size_t offset = 0;   // bytes into the ring
+        int count = 0;       // sprites
+        std::array<GLuint, kMaxTextureSlots> slots{};
+        int slotCount = 0;
+        std::array<GLint, kMaxShapes> shapes{};
+        int shapeCount = 1;
+    };
+
+    // pushRecorded: one recorder and where its sprites go in the staging buffer
+    struct RecordedJob {
+        const SpriteRecorder* rec;
+        size_t first;     // sprite index in the staging buffer (and in m_flagScratch, minus the base)
+    };
+    struct RecordWorkers; // persistent thread pool (SpriteBatch.cpp)
+
+    struct SortEntry {
+        std::uint64_t key;
+        std::uint32_t index;     // into m_deferred
     };
 
     bool loadTexture(const char* path);
+    bool recordPerSprite() const; // Instanced/Pulled: one SpriteInstance per sprite
+    size_t bytesPerSprite() const;
+    size_t ringBytes() const;
+    void resizeStaging();
+    GLenum indexType() const;
+    void uploadIndices();     // table for m_maxSprites quads (16-bit: capped), no CPU copy kept
+    void drawQuads(GLenum type, GLint baseVertex, int quads);
+    bool makeRoom();          // false = drop the sprite
+    void grow(int maxSprites);
+    void emit(const Sprite& s, int mode, std::uint32_t depthBits = 0); // expand one sprite into the staging buffer
+    void expand(const Sprite* s, const std::uint32_t* flags, size_t n); // n sprites at m_spriteCount
+    void expandAt(const Sprite* s, const std::uint32_t* flags, size_t n, size_t at); // count untouched
+    bool claimRecorded(std::span<const SpriteRecorder> recorders); // slots + shapes for all, or none
+    void expandRecorded(size_t job); // one recorder into its range; runs on any pushRecorded thread
+    int findSlot(GLuint tex) const; // -1 if not bound
+    bool deferred() const { return m_opt.sort != SpriteSort::None || m_opt.opaquePass; }
+    void drawDeferred();
+    void drawDepthPasses();   // opaquePass: m_sortKeys holds the back-to-front order
+    static void radixSort(std::vector<SortEntry>& a, std::vector<SortEntry>& tmp);
+    void bindSamplerUnits();
+    void flush();             // upload + draw what is queued, then reset the count
+    void drawStreamed(const StreamedDraw& d);
+    void bindRecords(GLuint tex); // Pulled: buffer texture on the unit after the sprite slots
+    unsigned int slotFor(GLuint tex); // texture unit for this sprite; may flush when all are taken
+    bool vertexShapes() const { return !recordPerSprite(); } // shape words go through m_shapes
+    int addShape(std::uint32_t word); // m_shapes index (0 = Quad), -1 if the table is full
+    void uploadShapes(const GLint* shapes, int count);
+    size_t vertexSize() const;   // vertex paths only
+    void setupVertexLayout(GLuint vbo);
+    void pointInstanceAttribs(size_t offset); // no base-instance in GL 3.3: re-point per flush
 
     GLuint m_vao = 0;
-    GLuint m_vbo = 0;     // dynamic (vertices)
-    GLuint m_ebo = 0;     // static (indices)
+    StreamBuffer m_stream; // vertices (ring)
+    GLuint m_ebo = 0;     // static (indices, all but Instanced)
+    GLuint m_recordTex = 0; // Pulled: GL_TEXTURE_BUFFER over m_stream
+    StreamedDraw m_last;  // last flush, for redrawLast()
+    int m_indexedQuads = 0;   // quads the uploaded table was built for
     GLuint m_tex = 0;
 
+    // Textures referenced by the queued sprites, bound to units 0..m_slotCount-1 at flush
+    std::array<GLuint, kMaxTextureSlots> m_slots{};
+    int m_slotCount = 0;
+    int m_maxSlots = 1;
+    unsigned int m_lastSlot = 0;
+
+    // Vertex paths: shape words of the queued sprites, sent as u_Shapes with the draw
+    std::array<GLint, kMaxShapes> m_shapes{};
+    int m_shapeCount = 1;
+    int m_lastShape = 0;
+
+    // Sorted modes: sprites are kept as-is until endAndDraw
+    struct DeferredSprite {
+        Sprite sprite;   // texture already resolved
+        int mode;
+    };
+    std::vector<DeferredSprite> m_deferred;
+    std::vector<SortEntry> m_sortKeys, m_sortScratch;
+    std::vector<std::uint32_t> m_opaqueOrder; // opaquePass: positions in m_sortKeys
+    std::unordered_set<GLuint> m_opaqueTextures;
+    int m_mode = 0;      // last setSampleMode()
+
     ShaderProgram m_prog;
-    GLint m_uP = -1;
     GLint m_uTex = -1;
-    GLint m_uMode = -1;
+    GLint m_uRecords = -1;
+    GLint m_uShapes = -1;
 
+    SpriteBatchOptions m_opt;
+    SimdLevel m_simd = SimdLevel::Scalar;
+    const SpriteKernels* m_kernels = nullptr;
+    std::vector<std::uint32_t> m_flagScratch; // pushMany/pushPoints: per-sprite flags of the current run
+    std::vector<RecordedJob> m_recordJobs;    // pushRecorded: this call's recorders
+    size_t m_recordBase = 0;                  // pushRecorded: m_spriteCount before the call
+    std::unique_ptr<RecordWorkers> m_recordWorkers;
     int   m_maxSprites = 0;
     int   m_spriteCount = 0;
 
+    unsigned long long m_overflows = 0;
+    unsigned long long m_dropped = 0;
+    unsigned long long m_grows = 0;
+    unsigned long long m_textureBreaks = 0;
+
     // CPU staging buffers (resized to capacity once)
     std::vector<Vertex>      m_cpuVerts;   // 4 verts per sprite
-    std::vector<unsigned int> m_cpuIndices;// 6 indices per sprite
+    std::vector<PackedVertex> m_cpuPacked; // 4 verts per sprite (PackedVertices)
+    std::vector<Instance>    m_cpuInstances; // 1 record per sprite (Instanced)
 };
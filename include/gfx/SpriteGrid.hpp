@@ -0,0 +1,71 @@
+// include/gfx/SpriteGrid.hpp
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "gfx/OrthoCamera2D.hpp"
+#include "gfx/Sprite.hpp"
+
+class SpriteBatch;
+
+// Sparse uniform grid of sprites for visibility culling. Scenes register sprites once
+// (and update() the ones that move); draw() submits only those overlapping the camera.
+// Sprites are bucketed by their world bounds (rotation included), so one sprite can sit in
+// several cells; queries return each once, in registration order, so overlapping
+// translucent sprites keep a stable draw order.
+class SpriteGrid {
+public:
+    using Id = std::uint32_t;
+
+    // cellSize in world units: ~1-4x a typical sprite, a fraction of the usual view
+    explicit SpriteGrid(float cellSize = 8.0f) : m_cell(cellSize), m_invCell(1.0f / cellSize) {}
+
+    void clear();
+    Id insert(const Sprite& s);
+    void update(Id id, const Sprite& s);   // moved/resized/recolored
+    void remove(Id id);                    // ids are not reused until clear()
+
+    const Sprite& sprite(Id id) const { return m_items[id].sprite; }
+    size_t size() const { return m_live; }
+
+    // Sprites overlapping r, appended to out in registration order
+    void query(const Rect2D& r, std::vector<Sprite>& out) const;
+
+    // Cull against the camera and pushMany the survivors; returns how many were submitted
+    size_t draw(SpriteBatch& batch, const OrthoCamera2D& cam) const;
+
+    static Rect2D bounds(const Sprite& s);
+
+private:
+    // Sprites covering more cells than this go to a list that every query scans instead
+    static constexpr int kMaxCellsPerSprite = 64;
+
+    struct CellRange { int x0, y0, x1, y1; };
+    struct Item {
+        Sprite sprite;
+        Rect2D bounds;
+        CellRange cells;
+        bool large = false;
+        bool live = false;
+    };
+
+    CellRange cellRange(const Rect2D& r) const;
+    static std::uint64_t key(int cx, int cy) {
+        return (std::uint64_t(std::uint32_t(cx)) << 32) | std::uint32_t(cy);
+    }
+    void link(Id id);
+    void unlink(Id id);
+
+    float m_cell, m_invCell;
+    std::vector<Item> m_items;
+    std::unordered_map<std::uint64_t, std::vector<Id>> m_cells;
+    std::vector<Id> m_large;
+    size_t m_live = 0;
+
+    // Query scratch (kept to avoid per-frame allocations)
+    mutable std::vector<std::uint32_t> m_stamp;  // per item: last query that saw it
+    mutable std::uint32_t m_query = 0;
+    mutable std::vector<Id> m_hits;
+    mutable std::vector<Sprite> m_visible;
+};
@@ -0,0 +1,23 @@
+// include/gfx/SpriteKernels.hpp
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "gfx/Simd.hpp"
+#include "gfx/Sprite.hpp"
+
+// Bulk sprite -> GPU record expansion. flags[i] is written verbatim into sprite i's record(s).
+// Vertex kernels write 4 corners per sprite (BL, BR, TL, TR), instance kernels one record.
+struct SpriteKernels {
+    void (*vertices)(const Sprite* s, const std::uint32_t* flags, size_t n, SpriteVertex* out);
+    void (*packed)(const Sprite* s, const std::uint32_t* flags, size_t n, SpritePackedVertex* out);
+    void (*instances)(const Sprite* s, const std::uint32_t* flags, size_t n, SpriteInstance* out);
+
+    // Points [first, first + n) of p, uv/shape from tmpl, flags[k] for point first + k. Read
+    // straight from the arrays, so nothing is gathered into Sprites first.
+    void (*pointVertices)(const SpritePoints& p, size_t first, size_t n, const Sprite& tmpl, const std::uint32_t* flags, SpriteVertex* out);
+    void (*pointPacked)(const SpritePoints& p, size_t first, size_t n, const Sprite& tmpl, const std::uint32_t* flags, SpritePackedVertex* out);
+    void (*pointInstances)(const SpritePoints& p, size_t first, size_t n, const Sprite& tmpl, const std::uint32_t* flags, SpriteInstance* out);
+};
+
+// Kernel table for a tier; pass resolveSimdLevel(...) to stay within what the CPU supports
+const SpriteKernels& spriteKernels(SimdLevel level);
@@ -0,0 +1,97 @@
+// include/gfx/SpriteRecorder.hpp
+#pragma once
+#include <glad/glad.h>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "gfx/Sprite.hpp"
+
+// CPU-only sprite list that a worker thread can fill while other threads fill theirs
+// (no GL calls, no shared state). Hand the finished recorders to SpriteBatch::pushRecorded
+// on the render thread; they are drawn in the order given there, not the order the
+// threads finished, so the output is deterministic.
+//
+// Texture and sample mode are captured per sprite as it is recorded, like SpriteBatch's
+// setTexture/setSampleMode. The recorder also keeps the distinct textures and shape words
+// it saw, so pushRecorded can assign texture slots and shape entries up front and expand
+// every recorder into its own staging range in parallel.
+//
+//   std::vector<SpriteRecorder> rec(workers);
+//   parallel for w: rec[w].clear(); generate(region[w], rec[w]);
+//   batch.pushRecorded(rec, workers);
+class SpriteRecorder {
+public:
+    // Past these the tables are not tracked and pushRecorded merges this recorder serially
+    static constexpr size_t kMaxTextures = 16;
+    static constexpr size_t kMaxShapes = 64;
+
+    void reserve(size_t n) {
+        m_sprites.reserve(n);
+        m_modes.reserve(n);
+    }
+    // Keeps capacity, so steady-state frames don't allocate; texture and mode go back to 0
+    void clear() {
+        m_sprites.clear();
+        m_modes.clear();
+        m_textures.clear();
+        m_shapes.clear();
+        m_untracked = false;
+        m_tex = 0;
+        m_mode = 0;
+    }
+
+    void setTexture(GLuint tex) { m_tex = tex; } // for sprites with Sprite::texture == 0; 0 = the batch's
+    void setSampleMode(int mode) { m_mode = static_cast<std::uint8_t>(mode & 0xF); }
+
+    void push(const Sprite& s) {
+        m_sprites.push_back(s);
+        record(m_sprites.back());
+    }
+    void pushMany(std::span<const Sprite> s) {
+        const size_t first = m_sprites.size();
+        m_sprites.insert(m_sprites.end(), s.begin(), s.end());
+        for (size_t i = first; i < m_sprites.size(); ++i) record(m_sprites[i]);
+    }
+
+    size_t size() const { return m_sprites.size(); }
+    bool empty() const { return m_sprites.empty(); }
+    std::span<const Sprite> sprites() const { return m_sprites; } // texture 0 = the batch's
+    std::span<const std::uint8_t> modes() const { return m_modes; } // sample mode per sprite
+
+    // Distinct textures (0 = the batch's) and non-Quad packSpriteShape words, first use first;
+    // only meaningful while tracked()
+    std::span<const GLuint> textures() const { return m_textures; }
+    std::span<const std::uint32_t> shapes() const { return m_shapes; }
+    bool tracked() const { return !m_untracked; }
+
+private:
+    void record(Sprite& s) {
+        if (!s.texture) s.texture = m_tex;
+        m_modes.push_back(m_mode);
+        if (m_untracked) return;
+        // Consecutive sprites usually share both, so the last entry is checked first
+        if (m_textures.empty() || m_textures.back() != s.texture) note(m_textures, s.texture, kMaxTextures);
+        if (s.shape != SpriteShape::Quad) {
+            const std::uint32_t word = packSpriteShape(s);
+            if (m_shapes.empty() || m_shapes.back() != word) note(m_shapes, word, kMaxShapes);
+        }
+    }
+
+    template <typename T>
+    void note(std::vector<T>& table, T value, size_t cap) {
+        for (const T& v : table) {
+            if (v == value) return;
+        }
+        if (table.size() == cap) m_untracked = true;
+        else table.push_back(value);
+    }
+
+    std::vector<Sprite> m_sprites;
+    std::vector<std::uint8_t> m_modes;
+    std::vector<GLuint> m_textures;
+    std::vector<std::uint32_t> m_shapes;
+    bool m_untracked = false; // a table overflowed
+    GLuint m_tex = 0;
+    std::uint8_t m_mode = 0;
+};
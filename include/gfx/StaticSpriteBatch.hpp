@@ -0,0 +1,50 @@
+// include/gfx/StaticSpriteBatch.hpp
+#pragma once
+#include <glad/glad.h>
+#include <array>
+#include <vector>
+#include "gfx/SpriteBatch.hpp"
+
+// Sprites recorded once into GL_STATIC_DRAW buffers and redrawn without re-uploading.
+// Filled by SpriteBatch::buildStatic (in that batch's vertex format) and drawn with
+// SpriteBatch::drawStatic under whatever VP the batch currently has.
+// Contents stay until invalidate(); dirty() tells the owner when to rebuild.
+class StaticSpriteBatch {
+public:
+    StaticSpriteBatch() = default;
+    ~StaticSpriteBatch() { shutdown(); }
+    StaticSpriteBatch(const StaticSpriteBatch&) = delete;
+    StaticSpriteBatch& operator=(const StaticSpriteBatch&) = delete;
+
+    void shutdown();
+
+    // Force a rebuild (layout/colors changed); the GL buffers are reused by the next build
+    void invalidate() { m_dirty = true; }
+    bool dirty() const { return m_dirty; }
+
+    int spriteCount() const { return m_spriteCount; }
+    int drawCount() const { return static_cast<int>(m_runs.size()); } // one per texture-slot/shape-table run
+
+private:
+    friend class SpriteBatch;
+
+    // Consecutive sprites that fit in one set of texture units (and one shape table)
+    struct Run {
+        int first = 0;   // sprite index
+        int count = 0;
+        std::array<GLuint, SpriteBatch::kMaxTextureSlots> slots{};
+        int slotCount = 0;
+        std::array<GLint, SpriteBatch::kMaxShapes> shapes{};
+        int shapeCount = 1;
+    };
+
+    GLuint m_vao = 0;
+    GLuint m_vbo = 0;
+    GLuint m_ebo = 0;    // all but Instanced
+    GLuint m_recordTex = 0; // Pulled: buffer texture over m_vbo
+    GLenum m_indexType = GL_UNSIGNED_SHORT;
+    SpriteSubmit m_submit = SpriteSubmit::Vertices; // format the VAO was laid out for
+    int m_spriteCount = 0;
+    std::vector<Run> m_runs;
+    bool m_dirty = true;
+};
@@ -0,0 +1,79 @@
+// include/gfx/StreamBuffer.hpp
+#pragma once
+#include <glad/glad.h>
+#include <cstddef>
+#include <deque>
+
+// How a StreamBuffer hands out GPU memory for per-flush data
+enum class StreamMode {
+    SubData,        // legacy: glBufferSubData at offset 0 every flush (driver may stall or shadow-copy)
+    Orphan,         // ring; orphan the whole store (glBufferData nullptr) when the ring wraps
+    Unsynchronized  // ring; map unsynchronized, one fence per written region, wait only on reuse
+};
+
+// Counters so the ring can be sized: stalls > 0 means the GPU was still reading what we wanted to overwrite
+struct StreamStats {
+    unsigned long long writes = 0;  // regions written
+    unsigned long long bytes = 0;   // bytes uploaded
+    unsigned long long wraps = 0;   // times the write cursor went back to offset 0
+    unsigned long long stalls = 0;  // times the CPU had to block on a fence
+};
+
+// Multi-region streaming buffer. Each write() lands in a region the GPU is not reading,
+// so the driver never has to synchronize with an in-flight draw.
+class StreamBuffer {
+public:
+    StreamBuffer() = default;
+    ~StreamBuffer() { shutdown(); }
+    StreamBuffer(const StreamBuffer&) = delete;
+    StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+    // target: GL_ARRAY_BUFFER, GL_TEXTURE_BUFFER, ...; bytes = whole ring size
+    bool init(GLenum target, size_t bytes, StreamMode mode);
+    void shutdown();
+
+    // Copy 'bytes' into the ring; returns the byte offset it was written at.
+    // The offset is a multiple of 'align' (so it can be turned into a base vertex / instance).
+    // Leaves the buffer bound to its target.
+    size_t write(const void* data, size_t bytes, size_t align);
+
+    // Call right after the draw that consumes the last write(); guards that region
+    void fence();
+    // Call after another draw that reads the last fenced region again (nothing new written)
+    void refence();
+    // Guard any region returned by write(), once every draw reading it was issued (e.g. a
+    // uniform slot that stays bound across many draws, fenced when it is unbound)
+    void fenceRange(size_t begin, size_t end);
+
+    // Drop the store and reallocate with a new size (contents are lost)
+    bool resize(size_t bytes);
+
+    GLuint id() const { return m_buf; }
+    size_t capacity() const { return m_capacity; }
+    StreamMode mode() const { return m_mode; }
+
+    const StreamStats& stats() const { return m_stats; }
+    void resetStats() { m_stats = {}; }
+
+private:
+    struct Region {
+        GLsync sync;
+        size_t begin, end;
+    };
+
+    void waitForRange(size_t begin, size_t end);
+    void retireFrom(size_t begin);   // wrap: wait on every fence of the skipped tail [begin, capacity)
+    void waitAndDelete(GLsync sync); // blocks until signalled (counts a stall if not yet)
+    void dropFences();
+
+    GLuint m_buf = 0;
+    GLenum m_target = GL_ARRAY_BUFFER;
+    StreamMode m_mode = StreamMode::Unsynchronized;
+    size_t m_capacity = 0;
+    size_t m_cursor = 0;                    // next free byte
+    size_t m_lastBegin = 0, m_lastEnd = 0;  // region of the last write (for fence())
+    size_t m_fencedBegin = 0, m_fencedEnd = 0; // region of the last fence (for refence())
+    std::deque<Region> m_fences;            // oldest first (submission order)
+
+    StreamStats m_stats;
+};
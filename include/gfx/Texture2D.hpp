@@ -7,7 +7,11 @@ struct Texture2D
 	int width = 0;
 	int height = 0;
 	int channelAmount = 0;
+	bool opaque = false; // no texel with alpha < 255 (no alpha channel counts as opaque)
 	//path to the texture and set it to nearest crisp by defalt
 	bool load(const char* path, bool neareast = true);
 	void destroy();
-};
\ No newline at end of file
+};
+
+// True if 8-bit pixel data (1-4 channels) has no translucent texel
+bool alphaIsOpaque(const unsigned char* pixels, int width, int height, int channels);
\ No newline at end of file
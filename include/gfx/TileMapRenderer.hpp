@@ -0,0 +1,101 @@
+// include/gfx/TileMapRenderer.hpp
+#pragma once
+#include <glad/glad.h>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+#include "gfx/OrthoCamera2D.hpp"
+#include "gfx/Shader.hpp"
+
+class SpriteBatch;
+
+// Grid atlas: tile id t > 0 uses cell t - 1, counted left to right, bottom to top
+struct TileAtlas {
+    GLuint texture = 0;
+    int cols = 1, rows = 1;
+
+    bool contains(int tile) const { return tile > 0 && tile <= cols * rows; }
+
+    // Empty rect (0, 0, 0, 0) for ids with no cell
+    glm::vec4 uv(int tile) const {
+        if (!contains(tile)) return glm::vec4(0.0f);
+        const int cell = tile - 1;
+        const float du = 1.0f / static_cast<float>(cols), dv = 1.0f / static_cast<float>(rows);
+        const float u0 = static_cast<float>(cell % cols) * du, v0 = static_cast<float>(cell / cols) * dv;
+        return { u0, v0, u0 + du, v0 + dv };
+    }
+};
+
+// Large tile grids drawn from static buffers. The map is cut into chunkTiles x chunkTiles
+// chunks, each baked the first time it is on screen and again only after one of its tiles
+// changed. A baked chunk is one 4-byte record per non-empty tile (cell in the chunk + tile
+// id) that tilemap.vert expands into a quad against the atlas grid. draw() walks just the
+// chunk range under the camera: one program, one VAO and one instanced draw per visible
+// non-empty chunk, no per-tile CPU work. Tiles outside the atlas grid are not drawn.
+class TileMapRenderer {
+public:
+    using Tile = std::uint16_t;
+    static constexpr Tile kEmpty = 0;
+
+    TileMapRenderer() = default;
+    ~TileMapRenderer() { shutdown(); }
+    TileMapRenderer(const TileMapRenderer&) = delete;
+    TileMapRenderer& operator=(const TileMapRenderer&) = delete;
+
+    // tilemap.vert + sprite_batch.frag. origin = world position of tile (0, 0)'s bottom-left
+    // corner; all tiles start empty. chunkTiles is clamped to 1..256 (8-bit cells in the record).
+    bool init(const char* vsPath, const char* fsPath, int width, int height, float tileSize,
+        glm::vec2 origin, const TileAtlas& atlas, int chunkTiles = 64);
+    void shutdown();
+
+    void set(int x, int y, Tile t);           // re-bakes the chunk on its next draw if changed
+    Tile get(int x, int y) const;
+    void assign(std::span<const Tile> tiles); // whole map, row-major from the bottom row
+
+    // Bakes what became visible or changed, then draws the visible chunks with the batch's
+    // current VP and sample mode, after the sprites it has queued. Returns the number of chunks drawn.
+    int draw(SpriteBatch& batch, const OrthoCamera2D& cam);
+
+    // Free the GL buffers of chunks outside the view (they re-bake when seen again)
+    void releaseHidden(const OrthoCamera2D& cam);
+
+    int width() const { return m_width; }
+    int height() const { return m_height; }
+    Rect2D bounds() const;
+    unsigned long long bakeCount() const { return m_bakes; }
+
+private:
+    struct ChunkRange { int x0, y0, x1, y1; }; // inclusive; empty if x0 > x1
+
+    struct Chunk {
+        GLuint vbo = 0;   // tile records, GL_STATIC_DRAW
+        int count = 0;    // records (non-empty tiles)
+        bool dirty = true;
+    };
+
+    ChunkRange visibleChunks(const Rect2D& view) const;
+    void bake(int cx, int cy);
+    Chunk& chunk(int cx, int cy) { return m_chunks[static_cast<size_t>(cy) * m_chunksX + cx]; }
+
+    int m_width = 0, m_height = 0;
+    int m_chunkTiles = 64;
+    int m_chunksX = 0, m_chunksY = 0;
+    float m_tileSize = 1.0f;
+    glm::vec2 m_origin{ 0.0f };
+    TileAtlas m_atlas;
+
+    ShaderProgram m_prog;
+    GLint m_uTileToWorld = -1;
+    GLint m_uAtlasCols = -1;
+    GLint m_uAtlasRows = -1;
+    GLint m_uMode = -1;
+    GLuint m_vao = 0; // shared by every chunk; the record attribute is re-pointed per chunk
+
+    std::vector<Tile> m_tiles;               // row-major
+    std::vector<Chunk> m_chunks;             // row-major
+    std::vector<std::uint32_t> m_scratch;    // one chunk's records while baking
+    unsigned long long m_bakes = 0;
+};
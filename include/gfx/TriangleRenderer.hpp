@@ -22,7 +22,7 @@ private:
     GLuint m_tex = 0;
 
     ShaderProgram m_prog;
-    GLint m_uMVP = -1;
+    GLint m_uModel = -1;  // view-projection comes from FrameData
     GLint m_uTex = -1;
 
     // sprite placement in pixels
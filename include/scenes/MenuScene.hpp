@@ -1,5 +1,7 @@
 #pragma once
+#include <array>
 #include "engine/IScene.hpp"
+#include "gfx/StaticSpriteBatch.hpp"
 #include "ui/BitmapFont.hpp"
 
 class MenuScene : public IScene {
@@ -14,33 +16,58 @@ public:
     void update(const FrameInput& in, float /*dt*/) override {
         // hover & clicks in world units
         glm::vec2 m = cam_.screenToWorld(in.mouseX, in.mouseY);
-        hoveredStart_ = pointInRect(m, startCenter_, startSize_);
-        hoveredQuit_ = pointInRect(m, quitCenter_, quitSize_);
+        const bool start = pointInRect(m, startCenter_, startSize_);
+        const bool quit = pointInRect(m, quitCenter_, quitSize_);
+        if (start != hoveredStart_ || quit != hoveredQuit_) visualsChanged_ = true;
+        hoveredStart_ = start;
+        hoveredQuit_ = quit;
         if (hoveredStart_ && in.mouseLeftPressed) startRequested_ = true;
         if (hoveredQuit_ && in.mouseLeftPressed) quitRequested_ = true;
     }
     void render(SpriteBatch& batch) const override {
-        auto pushRectCentered = [&](glm::vec2 c, glm::vec2 sz, glm::vec4 col) 
+        auto rectCentered = [](glm::vec2 c, glm::vec2 sz, glm::vec4 col)
         {
             Sprite s{}; 
             s.pos = c - 0.5f * sz; 
             s.size = sz; 
             s.uv = { 0,0,1,1 }; 
             s.color = col; 
+            return s;
+        };
+        // Buttons: rounded panel, plus a light outline while hovered (same batch, one quad each)
+        auto pushButton = [&](glm::vec2 c, glm::vec2 sz, glm::vec4 col, bool hovered)
+        {
+            Sprite s = rectCentered(c, sz, col);
+            s.shape = SpriteShape::RoundedRect;
+            s.cornerRadius = 0.35f;
             batch.push(s);
+            if (hovered)
+            {
+                s.color = { 1.0f, 1.0f, 1.0f, 0.8f };
+                s.borderWidth = 0.08f;
+                batch.push(s);
+            }
         };
-        // backdrop panel
-        pushRectCentered({ 0,0 }, { 18.0f, 12.0f }, { 0.10f,0.10f,0.12f,1.0f });
-        // title bar
-        pushRectCentered(titleCenter_, titleSize_, { 0.18f,0.18f,0.22f,1.0f });
+        // Panels that never change live on the GPU; built on first use
+        if (panels_.dirty())
+        {
+            const std::array<Sprite, 3> panels = {
+                // backdrop panel
+                rectCentered({ 0,0 }, { 18.0f, 12.0f }, { 0.10f,0.10f,0.12f,1.0f }),
+                // title bar
+                rectCentered(titleCenter_, titleSize_, { 0.18f,0.18f,0.22f,1.0f }),
+                // (Optional) draw a thin separator
+                rectCentered({ 0,-0.5f }, { 12.0f, 0.08f }, { 0.5f,0.5f,0.5f,0.5f }),
+            };
+            batch.buildStatic(panels_, panels);
+        }
+        batch.drawStatic(panels_);
         // Start button
         glm::vec4 startCol = hoveredStart_ ? glm::vec4(0.30f, 0.80f, 0.40f, 1.0f) : glm::vec4(0.22f, 0.65f, 0.32f, 1.0f);
-        pushRectCentered(startCenter_, startSize_, startCol);
+        pushButton(startCenter_, startSize_, startCol, hoveredStart_);
         // Quit button
         glm::vec4 quitCol = hoveredQuit_ ? glm::vec4(0.85f, 0.35f, 0.35f, 1.0f) : glm::vec4(0.70f, 0.25f, 0.25f, 1.0f);
-        pushRectCentered(quitCenter_, quitSize_, quitCol);
-        // (Optional) draw a thin separator
-        pushRectCentered({ 0,-0.5f }, { 12.0f, 0.08f }, { 0.5f,0.5f,0.5f,0.5f });
+        pushButton(quitCenter_, quitSize_, quitCol, hoveredQuit_);
         // Note: no text yet; add bitmap font later if you want labels
     }
 
@@ -51,6 +78,9 @@ public:
     bool wantsStart() const { return startRequested_; }
     bool wantsQuit()  const { return quitRequested_; }
     void consumeRequests() { startRequested_ = quitRequested_ = false; }
+    // Static until hovered: App caches it in a layer and can sleep between inputs
+    bool animating() const override { return false; }
+    bool takeVisualChange() override { const bool c = visualsChanged_; visualsChanged_ = false; return c; }
     void renderText(SpriteBatch& batch, const BitmapFont& font) const
     {
         //choose glyph size in world units
@@ -79,6 +109,7 @@ private:
     }
 
     OrthoCamera2D cam_;
+    mutable StaticSpriteBatch panels_; // backdrop, title bar, separator
 
     // layout in world units (works for any aspect due to ortho height)
     glm::vec2 titleCenter_{ 0,4.5f }, titleSize_{ 16.0f, 2.0f };
@@ -87,4 +118,5 @@ private:
 
     bool hoveredStart_ = false, hoveredQuit_ = false;
     bool startRequested_ = false, quitRequested_ = false;
+    bool visualsChanged_ = true;
 };
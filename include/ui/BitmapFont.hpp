@@ -1,4 +1,6 @@
 #pragma once
+#include <algorithm>
+#include <array>
 #include <string>
 #include <glm/vec2.hpp>
 #include <glm/vec4.hpp>
@@ -81,6 +83,10 @@ struct BitmapFont
 		float advX = in_glyphWorld.x + in_letterSpacing;
 		float advY = in_glyphWorld.y + in_lineSpacing;
 
+		//glyphs go to the batch in runs so pushMany can expand them together
+		std::array<Sprite, 64> run;
+		size_t count = 0;
+
 		for (char c : str_text)
 		{
 			if (c == '\n')
@@ -90,13 +96,20 @@ struct BitmapFont
 				continue;
 			}
 			glm::vec4 uv = uvFor(c);
-			Sprite s{};
+			Sprite& s = run[count++];
+			s = Sprite{};
 			s.pos = pen;
 			s.size = in_glyphWorld;
 			s.uv = uv;
 			s.color = in_color;
-			batch.push(s);
+			s.texture = text;
+			if (count == run.size())
+			{
+				batch.pushMany({ run.data(), count });
+				count = 0;
+			}
 			pen.x += advX;
 		}
+		if (count > 0) batch.pushMany({ run.data(), count });
 	}
 };
\ No newline at end of file
@@ -1,25 +1,112 @@
 #version 330 core
+#ifndef SPRITE_MAX_TEXTURES
+#define SPRITE_MAX_TEXTURES 1
+#endif
 in vec2 vUV;
 in vec4 vColor;
-uniform sampler2D uTex;
-uniform int u_Mode;  // 0 = normal RGBA, 1 = font: alpha = 1 - red
+flat in uint vSlot;  // texture unit of this sprite (SpriteBatch binds unit i to uTex[i])
+flat in uint vMode;  // sample mode: 0 = normal RGBA, 1 = font: alpha = 1 - red,
+                     // 2 = alpha only, 3 = premultiplied (RenderLayer texture)
+flat in uint vShape; // packSpriteShape (gfx/Sprite.hpp), 0 = plain quad
+in vec2 vLocal;      // -1..1 across the quad
+uniform sampler2D uTex[SPRITE_MAX_TEXTURES];
 out vec4 FragColor;
 
+// GLSL 3.30 only allows constant indices into sampler arrays, so pick the unit with a
+// fixed chain. Gradients are taken outside the branch so mipmapping stays well-defined.
+#define SPRITE_SLOT(i) if (slot == uint(i)) return textureGrad(uTex[i], uv, dx, dy);
+vec4 sampleSlot(uint slot, vec2 uv) {
+    vec2 dx = dFdx(uv), dy = dFdy(uv);
+#if SPRITE_MAX_TEXTURES > 1
+    SPRITE_SLOT(1)
+#endif
+#if SPRITE_MAX_TEXTURES > 2
+    SPRITE_SLOT(2)
+#endif
+#if SPRITE_MAX_TEXTURES > 3
+    SPRITE_SLOT(3)
+#endif
+#if SPRITE_MAX_TEXTURES > 4
+    SPRITE_SLOT(4)
+#endif
+#if SPRITE_MAX_TEXTURES > 5
+    SPRITE_SLOT(5)
+#endif
+#if SPRITE_MAX_TEXTURES > 6
+    SPRITE_SLOT(6)
+#endif
+#if SPRITE_MAX_TEXTURES > 7
+    SPRITE_SLOT(7)
+#endif
+#if SPRITE_MAX_TEXTURES > 8
+    SPRITE_SLOT(8)
+#endif
+#if SPRITE_MAX_TEXTURES > 9
+    SPRITE_SLOT(9)
+#endif
+#if SPRITE_MAX_TEXTURES > 10
+    SPRITE_SLOT(10)
+#endif
+#if SPRITE_MAX_TEXTURES > 11
+    SPRITE_SLOT(11)
+#endif
+#if SPRITE_MAX_TEXTURES > 12
+    SPRITE_SLOT(12)
+#endif
+#if SPRITE_MAX_TEXTURES > 13
+    SPRITE_SLOT(13)
+#endif
+#if SPRITE_MAX_TEXTURES > 14
+    SPRITE_SLOT(14)
+#endif
+#if SPRITE_MAX_TEXTURES > 15
+    SPRITE_SLOT(15)
+#endif
+    return textureGrad(uTex[0], uv, dx, dy);
+}
+
+// Coverage of the rounded box (or ring, with a border) at this pixel. The distance is in
+// screen pixels: the quad's half extents come from the derivatives of vLocal, so scaling
+// and rotation keep the edge exactly `softness` pixels wide.
+float shapeCoverage() {
+    vec2 perPx = vec2(length(vec2(dFdx(vLocal.x), dFdy(vLocal.x))),
+                      length(vec2(dFdx(vLocal.y), dFdy(vLocal.y))));
+    if (vShape == 0u) return 1.0;
+    vec2  halfPx = 1.0 / max(perPx, vec2(1e-6));
+    float m      = min(halfPx.x, halfPx.y);
+    float radius = float(vShape & 0xFFu) / 255.0 * m;
+    float border = float((vShape >> 8) & 0xFFu) / 255.0 * m;
+    float soft   = max(float((vShape >> 16) & 0xFFu) / 16.0, 1e-3);
+
+    vec2  q = abs(vLocal * halfPx) - halfPx + radius;
+    float d = length(max(q, 0.0)) + min(max(q.x, q.y), 0.0) - radius; // < 0 inside
+    float cov = clamp(0.5 - d / soft, 0.0, 1.0);
+    if (border > 0.0) cov *= clamp(0.5 + (d + border) / soft, 0.0, 1.0);
+    return cov;
+}
+
 void main() {
-    vec4 t = texture(uTex, vUV);
-    if (u_Mode == 1) 
+    vec4 t = sampleSlot(vSlot, vUV);
+    float cov = shapeCoverage();
+    if (vMode == 1u)
     {
         // Font atlas: black glyphs on white background (opaque).
         // Use red channel as coverage and invert it.
         float alpha = 1.0 - t.r;
-        FragColor = vec4(vColor.rgb, vColor.a * alpha);
+        FragColor = vec4(vColor.rgb, vColor.a * alpha * cov);
+    }
+    else if (vMode == 2u)
+    {
+        FragColor = vec4(vColor.rgb, vColor.a * t.a * cov); // PNG alpha
     }
-    else if (u_Mode == 2) 
+    else if (vMode == 3u)
     {
-        FragColor = vec4(vColor.rgb, vColor.a * t.a); // PNG alpha
+        // Layer texels hold color * alpha; undo it so the usual alpha blend composites them
+        FragColor = vec4(t.rgb / max(t.a, 1e-5) * vColor.rgb, t.a * vColor.a * cov);
     }
-    else 
+    else
     {
         FragColor = t * vColor;
+        FragColor.a *= cov;
     }
 }
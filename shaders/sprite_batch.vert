@@ -1,15 +1,83 @@
 #version 330 core
+#ifndef SPRITE_MAX_SHAPES
+#define SPRITE_MAX_SHAPES 1
+#endif
+#if defined(SPRITE_INSTANCED)
+// One record per sprite (attribute divisor 1); the quad corner comes from gl_VertexID (strip 0..3)
+layout(location = 0) in vec4 iPosSize; // bottom-left xy, size zw
+layout(location = 1) in vec4 iUV;      // (u0, v0, u1, v1), unorm16
+layout(location = 2) in vec4 iColor;   // RGBA8 normalized tint
+layout(location = 3) in uint iFlags;   // bits 0-3: texture slot, 4-7: sample mode, 14-31: depth
+layout(location = 4) in float iRot;    // radians, counter-clockwise around the pivot
+layout(location = 5) in vec2 iPivot;   // pivot as a fraction of size
+layout(location = 6) in uint iShape;   // packSpriteShape (gfx/Sprite.hpp), 0 = plain quad
+#elif defined(SPRITE_PULLED)
+// The same 48-byte records, fetched as 3 RGBA32UI texels each; indexed draw, 4 vertices per sprite
+uniform usamplerBuffer u_Records;
+#else
 layout(location = 0) in vec2 aPos;    // screen-space (after model) in pixels
 layout(location = 1) in vec2 aUV;     // 0..1 (or atlas sub-rect)
 layout(location = 2) in vec4 aColor;  // per-vertex tint
+layout(location = 3) in uint aFlags;  // bits 0-3: texture slot, 4-7: sample mode, 8-13: shape, 14-31: depth
+// packSpriteShape words (gfx/Sprite.hpp) of this draw, indexed by flags bits 8-13; [0] = 0, plain quad
+uniform int u_Shapes[SPRITE_MAX_SHAPES];
+#endif
 
-uniform mat4 u_P; // orthographic projection in pixels
+// Per-frame camera data (FrameDataBlock in gfx/FrameData.hpp), shared by every program
+layout(std140) uniform FrameData {
+    mat4 u_VP;       // world -> clip of the current view
+    mat4 u_InvVP;    // clip -> world
+    vec4 u_Viewport; // width, height, 1/width, 1/height in pixels
+    vec4 u_Time;     // seconds, frame delta, frame index, 0
+};
 
 out vec2 vUV;
 out vec4 vColor;
+flat out uint vSlot;
+flat out uint vMode;
+flat out uint vShape;
+out vec2 vLocal;      // -1..1 across the quad (shape distance in sprite_batch.frag)
 
 void main() {
+#if defined(SPRITE_INSTANCED) || defined(SPRITE_PULLED)
+#ifdef SPRITE_PULLED
+    // gl_VertexID includes the base vertex, so it counts from the start of the buffer
+    int  rec = (gl_VertexID >> 2) * 3;
+    int  vid = gl_VertexID & 3;
+    uvec4 t0 = texelFetch(u_Records, rec);
+    uvec4 t1 = texelFetch(u_Records, rec + 1);
+    uvec4 t2 = texelFetch(u_Records, rec + 2);
+    vec4  iPosSize = uintBitsToFloat(t0);
+    vec4  iUV      = vec4(uvec4(t1.xx, t1.yy) >> uvec4(0u, 16u, 0u, 16u) & 0xFFFFu) / 65535.0;
+    vec4  iColor   = vec4((uvec4(t1.z) >> uvec4(0u, 8u, 16u, 24u)) & 0xFFu) / 255.0;
+    uint  iFlags   = t1.w;
+    float iRot     = uintBitsToFloat(t2.x);
+    vec2  iPivot   = vec2(float(t2.y & 0xFFFFu), float(t2.y >> 16)) / 65535.0;
+    uint  iShape   = t2.z;
+#else
+    int  vid = gl_VertexID;
+#endif
+    // 0 = bottom-left, 1 = bottom-right, 2 = top-left, 3 = top-right
+    vec2 corner = vec2(float(vid & 1), float(vid >> 1));
+    vec2 local  = (corner - iPivot) * iPosSize.zw;
+    float c = cos(iRot), s = sin(iRot);
+    vec2 aPos   = iPosSize.xy + iPivot * iPosSize.zw + vec2(c * local.x - s * local.y, s * local.x + c * local.y);
+    vUV    = mix(iUV.xy, iUV.zw, corner);
+    vColor = iColor;
+    vShape = iShape;
+    uint aFlags = iFlags;
+#else
+    // Corners are written BL, BR, TL, TR and every draw starts on a multiple of 4
+    vec2 corner = vec2(float(gl_VertexID & 1), float((gl_VertexID >> 1) & 1));
     vUV    = aUV;
     vColor = aColor;
-    gl_Position = u_P * vec4(aPos, 0.0, 1.0);
+    vShape = uint(u_Shapes[(aFlags >> 8) & 0x3Fu]);
+#endif
+    vLocal = corner * 2.0 - 1.0;
+    vSlot  = aFlags & 0xFu;
+    vMode  = (aFlags >> 4) & 0xFu;
+    gl_Position = u_VP * vec4(aPos, 0.0, 1.0);
+    // Opaque pass: draw order as depth, later sprites nearer (see SpriteBatch depthBits)
+    uint depth = aFlags >> 14;
+    if (depth != 0u) gl_Position.z = (1.0 - float(depth) * exp2(-18.0)) * gl_Position.w;
 }
@@ -0,0 +1,40 @@
+#version 330 core
+// One 4-byte record per non-empty tile (attribute divisor 1); the quad corner comes from
+// gl_VertexID (strip 0..3). Feeds sprite_batch.frag with a single texture slot and no shape.
+layout(location = 0) in uint aTile; // bits 0-7: column in the chunk, 8-15: row, 16-31: tile id
+
+uniform mat4 u_TileToWorld; // chunk tile units -> world (chunk origin, tile size)
+uniform int  u_AtlasCols;   // TileAtlas grid; tile id t samples cell t - 1
+uniform int  u_AtlasRows;
+uniform int  u_Mode;        // SpriteBatch sample mode
+
+// Per-frame camera data (FrameDataBlock in gfx/FrameData.hpp), shared by every program
+layout(std140) uniform FrameData {
+    mat4 u_VP;       // world -> clip of the current view
+    mat4 u_InvVP;    // clip -> world
+    vec4 u_Viewport; // width, height, 1/width, 1/height in pixels
+    vec4 u_Time;     // seconds, frame delta, frame index, 0
+};
+
+out vec2 vUV;
+out vec4 vColor;
+flat out uint vSlot;
+flat out uint vMode;
+flat out uint vShape;
+out vec2 vLocal;
+
+void main() {
+    // 0 = bottom-left, 1 = bottom-right, 2 = top-left, 3 = top-right
+    vec2 corner = vec2(float(gl_VertexID & 1), float(gl_VertexID >> 1));
+    vec2 cellPos = vec2(float(aTile & 0xFFu), float((aTile >> 8) & 0xFFu));
+    int  cell = int(aTile >> 16) - 1; // ids are checked against the grid when the chunk is baked
+
+    vUV    = (vec2(float(cell % u_AtlasCols), float(cell / u_AtlasCols)) + corner)
+           / vec2(float(u_AtlasCols), float(u_AtlasRows));
+    vColor = vec4(1.0);
+    vSlot  = 0u;
+    vMode  = uint(u_Mode);
+    vShape = 0u;
+    vLocal = corner * 2.0 - 1.0;
+    gl_Position = u_VP * (u_TileToWorld * vec4(cellPos + corner, 0.0, 1.0));
+}
@@ -2,11 +2,19 @@
 layout(location = 0) in vec2 aPos;
 layout(location = 1) in vec3 aCol;
 
-uniform mat4 u_MVP;
+// Per-frame camera data (FrameDataBlock in gfx/FrameData.hpp), shared by every program
+layout(std140) uniform FrameData {
+    mat4 u_VP;       // world -> clip of the current view
+    mat4 u_InvVP;    // clip -> world
+    vec4 u_Viewport; // width, height, 1/width, 1/height in pixels
+    vec4 u_Time;     // seconds, frame delta, frame index, 0
+};
+
+uniform mat4 u_Model;
 
 out vec3 vCol;
 
 void main() {
     vCol = aCol;
-    gl_Position = u_MVP * vec4(aPos, 0.0, 1.0);
+    gl_Position = u_VP * u_Model * vec4(aPos, 0.0, 1.0);
 }
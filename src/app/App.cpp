@@ -1,9 +1,11 @@
 #include "app/App.hpp"
+#include "gfx/FrameData.hpp"
 #include <cstdio>
 #include <cstdlib>
 #include <glm/vec4.hpp>
 #include <chrono>
 #include <algorithm> 
+#include <string>
 
 // If you kept stbi_set_flip_vertically_on_load(true), row 0 = bottom row.
 // cols, rows = grid size. frame = 0..(cols*rows-1)
@@ -20,18 +22,27 @@ static inline glm::vec4 gridUV(int frame, int cols, int rows) {
 void App::onError(int code, const char* desc) {
     std::fprintf(stderr, "[GLFW %d] %s\n", code, desc);
 }
+void App::wake(GLFWwindow* win) {
+    if (auto* app = static_cast<App*>(glfwGetWindowUserPointer(win))) app->wake_ = true;
+}
+
+void App::onRefresh(GLFWwindow* win) { wake(win); } // exposed/damaged: present again
+
 void App::onKey(GLFWwindow* win, int key, int, int action, int) {
+    wake(win);
     if (action == GLFW_PRESS && key == GLFW_KEY_ESCAPE)
         glfwSetWindowShouldClose(win, GLFW_TRUE);
 }
 
 void App::onScroll(GLFWwindow* win, double, double yoff) {
+    wake(win);
     if (auto* app = static_cast<App*>(glfwGetWindowUserPointer(win))) {
         if (app->scene_) app->scene_->camera().zoomBy(static_cast<float>(yoff), 1.2f);
     }
 }
 
 void App::onMouseButton(GLFWwindow* win, int button, int action, int) {
+    wake(win);
     auto* app = static_cast<App*>(glfwGetWindowUserPointer(win));
     if (!app) return;
     if (button == GLFW_MOUSE_BUTTON_MIDDLE) {
@@ -46,6 +57,7 @@ void App::onMouseButton(GLFWwindow* win, int button, int action, int) {
 }
 
 void App::onCursorPos(GLFWwindow* win, double x, double y) {
+    wake(win);
     auto* app = static_cast<App*>(glfwGetWindowUserPointer(win));
     if (!app || !app->panning_) return;
     double dx = x - app->lastX_, dy = y - app->lastY_;
@@ -67,6 +79,7 @@ bool App::init(int w, int h, const char* title)
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_DEPTH_BITS, 24);   // SpriteBatch opaque pass
 
     #ifdef _DEBUG
         glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GLFW_TRUE);
@@ -87,19 +100,28 @@ bool App::init(int w, int h, const char* title)
     glfwSetKeyCallback(window_, App::onKey);
 
     // (optional but recommended for PNG with transparency)
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    device().enable(GL_BLEND);
+    device().blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
     glfwSetWindowUserPointer(window_, this);                 // allow callbacks to reach this App
     glfwSetScrollCallback(window_, App::onScroll);
     glfwSetMouseButtonCallback(window_, App::onMouseButton);
     glfwSetCursorPosCallback(window_, App::onCursorPos);
+    glfwSetWindowRefreshCallback(window_, App::onRefresh);
+    if (const char* ev = std::getenv("APP_EVENT_DRIVEN")) setEventDriven(ev[0] == '1');
 
 
     // init renderer with batch shaders + a texture (all sprites use this for now)
+    SpriteBatchOptions batchOpt;
+    batchOpt.maxSprites = 1024;    // small hot buffer; Flush handles spikes
+    batchOpt.overflow = SpriteOverflow::Flush;
+    batchOpt.ringFlushes = 3;   // 2 flushes per frame -> ~1.5 frames of slack before a fence wait
+    batchOpt.stream = StreamMode::Unsynchronized;
+    batchOpt.submit = SpriteSubmit::Vertices;   // or Instanced (1 record per sprite) to compare
+    batchOpt.opaquePass = true;    // backdrop/paddles: front-to-back, no blending, depth-rejected overdraw
     if (!spriteBatch_.init("shaders/sprite_batch.vert",
         "shaders/sprite_batch.frag",
-        "assets/white.png", /*maxSprites*/ 2000))
+        "assets/white.png", batchOpt))
         return false;
 
 
@@ -119,7 +141,17 @@ bool App::init(int w, int h, const char* title)
     uiFont_.last = 127;
     // Initial framebuffer size
     glfwGetFramebufferSize(window_, &fbw_, &fbh_);
-    glViewport(0, 0, fbw_, fbh_);
+    device().viewport(0, 0, fbw_, fbh_);
+
+    // Optional per-frame stats log
+    if (const char* path = std::getenv("APP_FRAME_STATS"))
+    {
+        const std::string p(path);
+        statsJson_ = p.ends_with(".json") || p.ends_with(".jsonl");
+        statsLog_.open(p, std::ios::out | std::ios::trunc);
+        if (!statsLog_) std::fprintf(stderr, "[App] Cannot open stats log %s\n", path);
+        else if (!statsJson_) writeFrameStatsCsvHeader(statsLog_);
+    }
 
     // Create current scene
     scene_ = std::make_unique<MenuScene>();
@@ -136,9 +168,17 @@ void App::run()
 
     const double dtFixed = 1.0 / 120.0;
 
+    // A stats frame spans from one presented frame to the next, so skipped idle iterations
+    // neither advance the frame index nor show up as empty rows
+    beginFrameStats();
     while (!glfwWindowShouldClose(window_)) 
     {
-        glfwPollEvents();
+        // Nothing animates and nothing happened since the last drawn frame: sleep until
+        // input (callbacks set wake_) or the timeout
+        if (eventDriven_ && !wake_ && scene_ && !scene_->animating())
+            glfwWaitEventsTimeout(kIdleTimeout);
+        else
+            glfwPollEvents();
 
         // Resize
         int w, h;
@@ -146,8 +186,9 @@ void App::run()
         if (w != fbw_ || h != fbh_) 
         {
             fbw_ = w; fbh_ = h;
-            glViewport(0, 0, fbw_, fbh_);
+            device().viewport(0, 0, fbw_, fbh_);
             if (scene_) scene_->resize(fbw_, fbh_);
+            wake_ = true;
         }
 
         // Input keyboard
@@ -201,38 +242,85 @@ void App::run()
                 menu->consumeRequests();
                 scene_ = std::make_unique<PongScene>();
                 scene_->init(fbw_, fbh_);
+                wake_ = true;
                 continue;
             }
         }
 
+        // Same picture as the last presented frame: skip render and swap
+        const bool changed = scene_ ? scene_->takeVisualChange() : false;
+        if (eventDriven_ && !wake_ && !changed && scene_ && !scene_->animating())
+        {
+            ++idleFrames_;
+            continue;
+        }
+        wake_ = false;
+
         // Render
-        glClear(GL_COLOR_BUFFER_BIT);
+        frameData().beginFrame(fbw_, fbh_, glfwGetTime(), static_cast<float>(frameDt));
+        device().clear(GL_COLOR_BUFFER_BIT);
         if (scene_) 
         {
-            //UI 
-            spriteBatch_.beginWithVP(scene_->camera().vp());
-            spriteBatch_.setTexture(whiteTex_);
-            spriteBatch_.setSampleMode(0);            // normal RGBA
-            scene_->render(spriteBatch_);
-            spriteBatch_.endAndDraw();
-
-            //TEXT
-            spriteBatch_.beginWithVP(scene_->camera().vp());
-            spriteBatch_.setTexture(uiFont_.text);
-            spriteBatch_.setSampleMode(2);            // red-as-alpha (inverted)
-            //Only menu render text
-            if (auto* menu = dynamic_cast<MenuScene*>(scene_.get()))
+            const glm::mat4 vp = scene_->camera().vp();
+            auto* menu = dynamic_cast<MenuScene*>(scene_.get());
+            if (menu && menuLayer_.resize(fbw_, fbh_))
             {
-                menu->renderText(spriteBatch_, uiFont_);
+                // The menu only changes on hover (or pan/zoom): redraw it into the layer then,
+                // otherwise the frame is one textured quad
+                if (changed) menuLayer_.invalidate();
+                if (menuLayer_.needsCapture(vp))
+                {
+                    menuLayer_.beginCapture(vp);
+                    renderScene(vp);
+                    menuLayer_.endCapture(fbw_, fbh_);
+                }
+                spriteBatch_.beginWithVP(vp);
+                spriteBatch_.setSampleMode(RenderLayer::kSampleMode);
+                spriteBatch_.push(menuLayer_.sprite(scene_->camera().visibleRect()));
+                spriteBatch_.endAndDraw();
+            }
+            else
+            {
+                if (menuLayer_.texture()) menuLayer_.shutdown();
+                renderScene(vp);
             }
-            spriteBatch_.endAndDraw();
         }
         glfwSwapBuffers(window_);
+
+        lastStats_ = frameStats();
+        if (statsLog_.is_open())
+        {
+            if (statsJson_) writeFrameStatsJson(statsLog_, lastStats_);
+            else writeFrameStatsCsv(statsLog_, lastStats_);
+        }
+        beginFrameStats();
+    }
+}
+
+void App::renderScene(const glm::mat4& vp)
+{
+    //UI and text share one batch: the sample mode travels with each sprite, so the glyphs
+    //(font texture, alpha mode) land in the same draw, on top of the panels pushed before them
+    spriteBatch_.beginWithVP(vp);
+    spriteBatch_.setTexture(whiteTex_);
+    spriteBatch_.setSampleMode(0);            // normal RGBA
+    scene_->render(spriteBatch_);
+
+    //TEXT (glyph sprites carry uiFont_.text themselves)
+    //Only menu render text
+    if (auto* menu = dynamic_cast<MenuScene*>(scene_.get()))
+    {
+        spriteBatch_.setSampleMode(2);        // PNG alpha
+        menu->renderText(spriteBatch_, uiFont_);
     }
+    spriteBatch_.endAndDraw();
 }
 
 App::~App() {
+    scene_.reset();   // scenes own GL buffers; release them while the context is alive
+    menuLayer_.shutdown();
     spriteBatch_.shutdown();
+    frameData().shutdown();
     if (window_) glfwDestroyWindow(window_);
     glfwTerminate();
 }
@@ -0,0 +1,78 @@
+// Headless SpriteBatch microbenchmark: no window, no GL context. Every gfx call goes through
+// the state cache into a RecordingRenderDevice, so the numbers are the CPU cost of building
+// and submitting the frames plus what would have reached the driver.
+//
+//   sprite_bench [sprites per frame = 100000] [frames = 200]
+#include "gfx/RenderDevice.hpp"
+#include "gfx/SpriteBatch.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <glm/glm.hpp>
+
+static const char* submitName(SpriteSubmit s) {
+    switch (s) {
+    case SpriteSubmit::Vertices: return "vertices";
+    case SpriteSubmit::PackedVertices: return "packed";
+    case SpriteSubmit::Instanced: return "instanced";
+    case SpriteSubmit::Pulled: return "pulled";
+    }
+    return "?";
+}
+
+int main(int argc, char** argv)
+{
+    const int sprites = (argc > 1) ? std::max(1, std::atoi(argv[1])) : 100000;
+    const int frames = (argc > 2) ? std::max(1, std::atoi(argv[2])) : 200;
+
+    RecordingRenderDevice rec;
+    setRenderDevice(&rec);
+
+    // Half the sprites rotated so both kernel paths run; two textures so slots are used
+    std::vector<Sprite> scene(static_cast<size_t>(sprites));
+    for (size_t i = 0; i < scene.size(); ++i) {
+        Sprite& s = scene[i];
+        s.pos = { static_cast<float>(i % 1000), static_cast<float>(i / 1000) };
+        s.size = { 8.0f, 8.0f };
+        s.color = { 1.0f, 1.0f, 1.0f, 1.0f };
+        s.rotation = (i & 1) ? 0.3f : 0.0f;
+        s.texture = (i & 2) ? 2 : 0;
+    }
+
+    std::printf("submit,ms_per_frame,calls,draws,binds,uniforms,syncs,buffer_bytes\n");
+    for (SpriteSubmit sub : { SpriteSubmit::Vertices, SpriteSubmit::PackedVertices, SpriteSubmit::Instanced, SpriteSubmit::Pulled }) {
+        SpriteBatchOptions opt;
+        opt.submit = sub;
+        opt.maxSprites = 20000;
+        SpriteBatch batch;
+        if (!batch.init("shaders/sprite_batch.vert", "shaders/sprite_batch.frag", "assets/white.png", opt)) {
+            std::fprintf(stderr, "[sprite_bench] init failed (run from the directory holding shaders/ and assets/)\n");
+            return 1;
+        }
+
+        // One warm-up frame so first-use costs (ring, cache) stay out of the average
+        batch.beginWithVP(glm::mat4(1.0f));
+        batch.pushMany(scene);
+        batch.endAndDraw();
+        rec.resetStats();
+
+        const auto t0 = std::chrono::steady_clock::now();
+        for (int f = 0; f < frames; ++f) {
+            batch.beginWithVP(glm::mat4(1.0f));
+            batch.pushMany(scene);
+            batch.endAndDraw();
+        }
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count() / frames;
+
+        const DeviceStats& st = rec.stats();
+        const double n = static_cast<double>(frames);
+        std::printf("%s,%.4f,%.1f,%.1f,%.1f,%.1f,%.1f,%.0f\n", submitName(sub), ms,
+            st.calls / n, st.draws / n, st.binds / n, st.uniforms / n, st.syncs / n, st.bufferBytes / n);
+        batch.shutdown();
+    }
+
+    setRenderDevice(nullptr);
+    return 0;
+}
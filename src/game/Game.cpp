@@ -1,5 +1,6 @@
 #include "game/Game.hpp"
 #include <algorithm>
+#include <array>
 #include <cstdio>
 #include <glm/gtc/constants.hpp>
 #include <glm/geometric.hpp>   // for glm::dot
@@ -22,10 +23,39 @@ bool Game::init(int fbw, int fbh) {
     L_.pos = { -courtHalfW_ + margin, 0.0f };
     R_.pos = { courtHalfW_ - margin, 0.0f };
 
+    ParticleParams trail;
+    trail.colorStart = { 1.0f, 1.0f, 1.0f, 0.35f };
+    trail.colorEnd = { 0.6f, 0.8f, 1.0f, 0.0f };
+    trail.sizeStart = ball_.radius * 1.6f;
+    trail.sizeEnd = 0.0f;
+    trail_.init(1024, trail);
+
+    ParticleParams sparks;
+    sparks.gravity = { 0.0f, -15.0f };
+    sparks.drag = 2.0f;
+    sparks.colorStart = { 1.0f, 0.85f, 0.4f, 1.0f };
+    sparks.colorEnd = { 1.0f, 0.3f, 0.1f, 0.0f };
+    sparks.sizeStart = 0.25f;
+    sparks.sizeEnd = 0.05f;
+    sparks_.init(4096, sparks);
+
     reset(/*serveRight=*/true);
     return true;
 }
 
+void Game::sparkBurst(const vec2& at, const vec2& normal, int count) {
+    ParticleBurst b;
+    b.pos = at;
+    b.angle = std::atan2(normal.y, normal.x);
+    b.spread = 0.9f;
+    b.speedMin = 4.0f;
+    b.speedMax = 10.0f;
+    b.lifeMin = 0.3f;
+    b.lifeMax = 0.6f;
+    b.count = count;
+    sparks_.emit(b);
+}
+
 void Game::resize(int fbw, int fbh) {
     camera_.setViewport(fbw, fbh);
     // keep world height stable (zoom), recompute width by aspect
@@ -70,6 +100,18 @@ void Game::update(const InputState& in, float dt) {
 
     // paddle collisions
     collideWithPaddles();
+
+    // effects
+    ParticleBurst t;
+    t.pos = ball_.pos;
+    t.jitter = { ball_.radius * 0.3f, ball_.radius * 0.3f };
+    t.speedMax = 0.6f;
+    t.lifeMin = 0.25f;
+    t.lifeMax = 0.4f;
+    t.count = 2;
+    trail_.emit(t);
+    trail_.update(dt);
+    sparks_.update(dt);
 }
 
 void Game::collideWithWalls() {
@@ -77,18 +119,22 @@ void Game::collideWithWalls() {
     if (ball_.pos.y + ball_.radius > courtHalfH_) {
         ball_.pos.y = courtHalfH_ - ball_.radius;
         ball_.vel.y = -ball_.vel.y;
+        sparkBurst(ball_.pos + vec2{ 0.0f, ball_.radius }, { 0.0f, -1.0f }, 8);
     }
     if (ball_.pos.y - ball_.radius < -courtHalfH_) {
         ball_.pos.y = -courtHalfH_ + ball_.radius;
         ball_.vel.y = -ball_.vel.y;
+        sparkBurst(ball_.pos - vec2{ 0.0f, ball_.radius }, { 0.0f, 1.0f }, 8);
     }
     // left/right scoring
     if (ball_.pos.x - ball_.radius < -courtHalfW_) {
         ++scoreR_; std::printf("Score: L %d  |  R %d\n", scoreL_, scoreR_);
+        sparkBurst(ball_.pos, { 1.0f, 0.0f }, 64);
         reset(/*serveRight=*/true);
     }
     if (ball_.pos.x + ball_.radius > courtHalfW_) {
         ++scoreL_; std::printf("Score: L %d  |  R %d\n", scoreL_, scoreR_);
+        sparkBurst(ball_.pos, { -1.0f, 0.0f }, 64);
         reset(/*serveRight=*/false);
     }
 }
@@ -127,6 +173,7 @@ void Game::collideWithPaddles() {
             vec2 dir = glm::normalize(vec2{ +1.0f, hit });
             ball_.speed = std::min(ball_.speed * 1.03f, 40.0f);
             ball_.vel = dir * ball_.speed;
+            sparkBurst(ball_.pos - n * ball_.radius, n, 24);
         }
     }
     // Right paddle
@@ -141,29 +188,39 @@ void Game::collideWithPaddles() {
             vec2 dir = glm::normalize(vec2{ -1.0f, hit });
             ball_.speed = std::min(ball_.speed * 1.03f, 40.0f);
             ball_.vel = dir * ball_.speed;
+            sparkBurst(ball_.pos - n * ball_.radius, n, 24);
         }
     }
 }
 
 void Game::render(SpriteBatch& batch) const {
-    auto pushCentered = [&](const glm::vec2& c, const glm::vec2& sz, const glm::vec4& col) {
+    auto centered = [](const glm::vec2& c, const glm::vec2& sz, const glm::vec4& col) {
         Sprite s{};
         s.pos = c - 0.5f * sz;   // center -> bottom-left for SpriteBatch
         s.size = sz;
         s.uv = { 0,0,1,1 };
         s.color = col;
-        batch.push(s);
+        return s;
         };
 
-    // Center line (full court height)
-    pushCentered({ 0.0f, 0.0f }, { 0.12f, courtHalfH_ * 2.0f }, { 0.5f, 0.5f, 0.5f, 1.0f });
-
-    // Paddles
-    pushCentered(L_.pos, L_.size, { 0.9f, 0.9f, 0.9f, 1.0f });
-    pushCentered(R_.pos, R_.size, { 0.9f, 0.9f, 0.9f, 1.0f });
+    // Center line (full court height) never moves; drawn from a static buffer
+    if (court_.dirty()) {
+        const Sprite line = centered({ 0.0f, 0.0f }, { 0.12f, courtHalfH_ * 2.0f }, { 0.5f, 0.5f, 0.5f, 1.0f });
+        batch.buildStatic(court_, { &line, 1 });
+    }
+    batch.drawStatic(court_);
+    trail_.render(batch);
 
-    // Ball (square; disc mask later if you want)
     const glm::vec2 ballSz{ ball_.radius * 2.0f, ball_.radius * 2.0f };
-    pushCentered(ball_.pos, ballSz, { 1.0f, 1.0f, 1.0f, 1.0f });
+    std::array<Sprite, 3> sprites = {
+        // Paddles
+        centered(L_.pos, L_.size, { 0.9f, 0.9f, 0.9f, 1.0f }),
+        centered(R_.pos, R_.size, { 0.9f, 0.9f, 0.9f, 1.0f }),
+        // Ball
+        centered(ball_.pos, ballSz, { 1.0f, 1.0f, 1.0f, 1.0f }),
+    };
+    sprites[2].shape = SpriteShape::Circle;
+    batch.pushMany(sprites);
+    sparks_.render(batch);
 }
 
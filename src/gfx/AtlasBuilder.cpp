@@ -0,0 +1,213 @@
+#include "gfx/AtlasBuilder.hpp"
+#include "gfx/FrameStats.hpp"
+#include "gfx/RenderDevice.hpp"
+#include "thirdparty/stb_image.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <iostream>
+#include <numeric>
+
+static int nextPow2(int v) {
+    int p = 1;
+    while (p < v) p <<= 1;
+    return p;
+}
+
+AtlasBuilder::AtlasBuilder(int pageSize, int padding)
+    : m_pageSize(std::max(pageSize, 1)), m_padding(std::max(padding, 0)) {}
+
+AtlasBuilder::Handle AtlasBuilder::add(const char* path) {
+    if (m_released) {
+        std::cerr << "[AtlasBuilder] add(" << path << ") after releasePixels(); atlas is frozen\n";
+        return -1;
+    }
+    int w = 0, h = 0, comp = 0;
+    stbi_set_flip_vertically_on_load(true); // bottom row first, like every other texture here
+    unsigned char* pixels = stbi_load(path, &w, &h, &comp, 4);
+    if (!pixels) {
+        std::cerr << "[AtlasBuilder] Failed to load texture: " << path << "\n";
+        return -1;
+    }
+    const Handle h0 = add(pixels, w, h);
+    stbi_image_free(pixels);
+    return h0;
+}
+
+AtlasBuilder::Handle AtlasBuilder::add(const unsigned char* rgba, int width, int height) {
+    if (!rgba || width <= 0 || height <= 0) return -1;
+    if (m_released) {
+        std::cerr << "[AtlasBuilder] add() after releasePixels(); atlas is frozen\n";
+        return -1;
+    }
+    Image img;
+    img.width = width;
+    img.height = height;
+    img.rgba.assign(rgba, rgba + static_cast<size_t>(width) * height * 4);
+    m_images.push_back(std::move(img));
+    m_regions.emplace_back();
+    return static_cast<Handle>(m_regions.size() - 1);
+}
+
+// Skyline bottom-left: the w x h rect goes where its top edge ends lowest (ties: the
+// narrower segment, which leaves fewer gaps), resting on the highest segment it spans.
+bool AtlasBuilder::place(Page& page, int size, int w, int h, int& outX, int& outY) {
+    std::vector<SkylineNode>& sky = page.skyline;
+    int bestTop = INT_MAX, bestWidth = INT_MAX;
+    size_t best = sky.size();
+    for (size_t i = 0; i < sky.size(); ++i) {
+        const int x = sky[i].x;
+        if (x + w > size) break; // segments are sorted by x
+        int y = 0;
+        for (size_t j = i, left = static_cast<size_t>(w); left > 0; ++j) {
+            y = std::max(y, sky[j].y);
+            left -= std::min(left, static_cast<size_t>(sky[j].width));
+        }
+        if (y + h > size) continue;
+        if (y + h < bestTop || (y + h == bestTop && sky[i].width < bestWidth)) {
+            bestTop = y + h;
+            bestWidth = sky[i].width;
+            best = i;
+            outY = y;
+        }
+    }
+    if (best == sky.size()) return false;
+    outX = sky[best].x;
+
+    // The new segment covers [x, x + w); trim or drop the ones it now hides
+    sky.insert(sky.begin() + static_cast<std::ptrdiff_t>(best), { outX, outY + h, w });
+    for (size_t k = best + 1; k < sky.size();) {
+        const int edge = sky[k - 1].x + sky[k - 1].width;
+        if (sky[k].x >= edge) break;
+        const int cut = edge - sky[k].x;
+        sky[k].x += cut;
+        sky[k].width -= cut;
+        if (sky[k].width > 0) break;
+        sky.erase(sky.begin() + static_cast<std::ptrdiff_t>(k));
+    }
+    for (size_t k = 1; k < sky.size();) {
+        if (sky[k - 1].y == sky[k].y) {
+            sky[k - 1].width += sky[k].width;
+            sky.erase(sky.begin() + static_cast<std::ptrdiff_t>(k));
+        }
+        else ++k;
+    }
+
+    page.usedW = std::max(page.usedW, outX + w);
+    page.usedH = std::max(page.usedH, outY + h);
+    return true;
+}
+
+bool AtlasBuilder::build(bool nearest) {
+    // Repacking needs every image's pixels; keep the current pages rather than lose regions
+    if (m_released) {
+        std::cerr << "[AtlasBuilder] build() after releasePixels(); keeping the current pages\n";
+        return false;
+    }
+    for (GLuint tex : m_pages) device().deleteTextures(1, &tex);
+    m_pages.clear();
+
+    GLint maxSize = 0;
+    device().getIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+    const int size = (maxSize > 0) ? std::min(m_pageSize, static_cast<int>(maxSize)) : m_pageSize;
+    const int pad = m_padding;
+
+    // Tallest first keeps the skyline flat
+    std::vector<size_t> order(m_images.size());
+    std::iota(order.begin(), order.end(), size_t(0));
+    std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+        if (m_images[a].height != m_images[b].height) return m_images[a].height > m_images[b].height;
+        return m_images[a].width > m_images[b].width;
+    });
+
+    bool ok = true;
+    std::vector<Page> pages;
+    for (size_t i : order) {
+        const Image& img = m_images[i];
+        AtlasRegion& r = m_regions[i];
+        r = {};
+        const int w = img.width + 2 * pad, h = img.height + 2 * pad;
+        int x = 0, y = 0;
+        size_t p = 0;
+        while (p < pages.size() && !place(pages[p], size, w, h, x, y)) ++p;
+        if (p == pages.size()) {
+            Page fresh;
+            fresh.skyline.push_back({ 0, 0, size });
+            if (!place(fresh, size, w, h, x, y)) {
+                std::cerr << "[AtlasBuilder] " << img.width << "x" << img.height << " image does not fit a "
+                    << size << " page\n";
+                ok = false;
+                continue;
+            }
+            pages.push_back(std::move(fresh));
+        }
+        r.page = static_cast<int>(p);
+        r.x = x + pad;
+        r.y = y + pad;
+        r.width = img.width;
+        r.height = img.height;
+    }
+
+    // Compose each page, edge texels repeated into the padding, then upload
+    for (size_t p = 0; p < pages.size(); ++p) {
+        const int pw = std::min(nextPow2(pages[p].usedW), size), ph = std::min(nextPow2(pages[p].usedH), size);
+        std::vector<unsigned char> pixels(static_cast<size_t>(pw) * ph * 4, 0);
+        for (size_t i = 0; i < m_images.size(); ++i) {
+            AtlasRegion& r = m_regions[i];
+            if (r.page != static_cast<int>(p)) continue;
+            const Image& img = m_images[i];
+            for (int row = -pad; row < img.height + pad; ++row) {
+                const unsigned char* src = &img.rgba[static_cast<size_t>(std::clamp(row, 0, img.height - 1)) * img.width * 4];
+                unsigned char* dst = &pixels[(static_cast<size_t>(r.y + row) * pw + r.x) * 4];
+                std::memcpy(dst, src, static_cast<size_t>(img.width) * 4);
+                for (int c = 1; c <= pad; ++c) {
+                    std::memcpy(dst - c * 4, src, 4);
+                    std::memcpy(dst + (img.width - 1 + c) * 4, src + (img.width - 1) * 4, 4);
+                }
+            }
+            r.uv = { static_cast<float>(r.x) / pw, static_cast<float>(r.y) / ph,
+                     static_cast<float>(r.x + r.width) / pw, static_cast<float>(r.y + r.height) / ph };
+        }
+        m_pages.push_back(upload(pixels, pw, ph, nearest));
+    }
+    for (AtlasRegion& r : m_regions) {
+        if (r.page >= 0) r.texture = m_pages[static_cast<size_t>(r.page)];
+    }
+    return ok;
+}
+
+GLuint AtlasBuilder::upload(const std::vector<unsigned char>& pixels, int w, int h, bool nearest) {
+    GLuint tex = 0;
+    device().genTextures(1, &tex);
+    device().bindTexture(GL_TEXTURE_2D, tex);
+    device().texParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, nearest ? GL_NEAREST : GL_LINEAR_MIPMAP_LINEAR);
+    device().texParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, nearest ? GL_NEAREST : GL_LINEAR);
+    device().texParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    device().texParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    // RGBA8 rows are always 4-byte aligned, so the default unpack alignment is fine
+    device().texImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    if (!nearest) {
+        // Level L texels span 2^L pixels; beyond log2(padding) they would reach the neighbours
+        int maxLevel = 0;
+        while ((2 << maxLevel) <= m_padding) ++maxLevel;
+        device().texParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, maxLevel);
+        device().generateMipmap(GL_TEXTURE_2D);
+    }
+    device().bindTexture(GL_TEXTURE_2D, 0);
+    ++frameStats().textureUploads;
+    frameStats().textureBytes += static_cast<unsigned long long>(w) * h * 4;
+    return tex;
+}
+
+void AtlasBuilder::releasePixels() {
+    for (Image& img : m_images) std::vector<unsigned char>().swap(img.rgba);
+    m_released = true;
+}
+
+void AtlasBuilder::shutdown() {
+    for (GLuint tex : m_pages) device().deleteTextures(1, &tex);
+    m_pages.clear();
+    m_images.clear();
+    m_regions.clear();
+    m_released = false;
+}
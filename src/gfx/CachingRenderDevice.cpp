@@ -0,0 +1,205 @@
+#include "gfx/CachingRenderDevice.hpp"
+#include <cstring>
+
+void CachingRenderDevice::invalidate() {
+    m_program = kUnknown;
+    m_vao = kUnknown;
+    m_buffers.fill(kUnknown);
+    m_activeUnit = 0;
+    for (auto& unit : m_textures) unit.fill(kUnknown);
+    m_caps.fill(Tri::Unknown);
+    m_blend = {};
+    m_depthFunc = 0;
+    m_depthMask = Tri::Unknown;
+    m_uniforms.clear();
+}
+
+int CachingRenderDevice::bufferSlot(GLenum target) {
+    switch (target) {
+    case GL_ARRAY_BUFFER: return ArrayBuffer;
+    case GL_ELEMENT_ARRAY_BUFFER: return ElementBuffer;
+    case GL_TEXTURE_BUFFER: return TextureBuffer;
+    default: return -1;
+    }
+}
+
+int CachingRenderDevice::textureSlot(GLenum target) {
+    switch (target) {
+    case GL_TEXTURE_2D: return Tex2D;
+    case GL_TEXTURE_BUFFER: return TexBuffer;
+    default: return -1;
+    }
+}
+
+int CachingRenderDevice::capSlot(GLenum cap) {
+    switch (cap) {
+    case GL_BLEND: return Blend;
+    case GL_DEPTH_TEST: return DepthTest;
+    default: return -1;
+    }
+}
+
+// ---------------------------------------------------------------- buffers / VAOs
+
+void CachingRenderDevice::bindBuffer(GLenum target, GLuint id) {
+    const int slot = bufferSlot(target);
+    if (slot >= 0) {
+        if (m_buffers[slot] == id && skip()) return;
+        m_buffers[slot] = id;
+    }
+    m_inner->bindBuffer(target, id);
+}
+
+void CachingRenderDevice::deleteBuffers(GLsizei n, const GLuint* ids) {
+    // GL unbinds deleted buffers from the current context
+    for (GLsizei i = 0; i < n; ++i)
+        for (GLuint& b : m_buffers)
+            if (b == ids[i]) b = 0;
+    m_inner->deleteBuffers(n, ids);
+}
+
+void CachingRenderDevice::bindVertexArray(GLuint id) {
+    if (m_vao == id && skip()) return;
+    m_vao = id;
+    m_buffers[ElementBuffer] = kUnknown; // part of the VAO
+    m_inner->bindVertexArray(id);
+}
+
+void CachingRenderDevice::deleteVertexArrays(GLsizei n, const GLuint* ids) {
+    for (GLsizei i = 0; i < n; ++i) {
+        if (m_vao == ids[i]) {
+            m_vao = 0;
+            m_buffers[ElementBuffer] = kUnknown;
+        }
+    }
+    m_inner->deleteVertexArrays(n, ids);
+}
+
+// ---------------------------------------------------------------- textures
+
+void CachingRenderDevice::activeTexture(GLenum unit) {
+    if (m_activeUnit == unit && skip()) return;
+    const bool tracked = unit >= GL_TEXTURE0 && unit < GL_TEXTURE0 + kUnits;
+    m_activeUnit = tracked ? unit : 0;
+    m_inner->activeTexture(unit);
+}
+
+void CachingRenderDevice::bindTexture(GLenum target, GLuint id) {
+    const int slot = textureSlot(target);
+    if (slot >= 0 && m_activeUnit != 0) {
+        GLuint& bound = m_textures[m_activeUnit - GL_TEXTURE0][slot];
+        if (bound == id && skip()) return;
+        bound = id;
+    }
+    m_inner->bindTexture(target, id);
+}
+
+void CachingRenderDevice::deleteTextures(GLsizei n, const GLuint* ids) {
+    for (GLsizei i = 0; i < n; ++i)
+        for (auto& unit : m_textures)
+            for (GLuint& t : unit)
+                if (t == ids[i]) t = 0;
+    m_inner->deleteTextures(n, ids);
+}
+
+// ---------------------------------------------------------------- programs / uniforms
+
+void CachingRenderDevice::useProgram(GLuint prog) {
+    if (m_program == prog && skip()) return;
+    m_program = prog;
+    ++frameStats().programBinds; // here, not in the devices: counted once whatever is behind
+    m_inner->useProgram(prog);
+}
+
+void CachingRenderDevice::forgetProgram(GLuint prog) {
+    for (auto it = m_uniforms.begin(); it != m_uniforms.end();) {
+        if (static_cast<GLuint>(it->first >> 32) == prog) it = m_uniforms.erase(it);
+        else ++it;
+    }
+}
+
+void CachingRenderDevice::linkProgram(GLuint prog) {
+    forgetProgram(prog); // linking resets every uniform
+    m_inner->linkProgram(prog);
+}
+
+void CachingRenderDevice::deleteProgram(GLuint prog) {
+    forgetProgram(prog);
+    if (m_program == prog) m_program = kUnknown;
+    m_inner->deleteProgram(prog);
+}
+
+bool CachingRenderDevice::sameUniform(GLint loc, const void* data, size_t bytes) {
+    if (loc < 0 || m_program == kUnknown || m_program == 0) return false;
+    const std::uint64_t key = (std::uint64_t(m_program) << 32) | static_cast<std::uint32_t>(loc);
+    std::vector<std::uint32_t>& v = m_uniforms[key];
+    const size_t words = bytes / sizeof(std::uint32_t);
+    if (v.size() == words && std::memcmp(v.data(), data, bytes) == 0) return true;
+    v.resize(words);
+    std::memcpy(v.data(), data, bytes);
+    return false;
+}
+
+void CachingRenderDevice::uniform1i(GLint loc, GLint value) {
+    if (sameUniform(loc, &value, sizeof(value)) && skip()) return;
+    m_inner->uniform1i(loc, value);
+}
+
+void CachingRenderDevice::uniform1iv(GLint loc, GLsizei count, const GLint* v) {
+    if (sameUniform(loc, v, static_cast<size_t>(count) * sizeof(GLint)) && skip()) return;
+    m_inner->uniform1iv(loc, count, v);
+}
+
+void CachingRenderDevice::uniformMatrix4fv(GLint loc, GLsizei count, GLboolean transpose, const GLfloat* m) {
+    // Transposed uploads are rare; don't cache them rather than track the flag
+    if (!transpose && sameUniform(loc, m, static_cast<size_t>(count) * 16 * sizeof(GLfloat)) && skip()) return;
+    m_inner->uniformMatrix4fv(loc, count, transpose, m);
+}
+
+// ---------------------------------------------------------------- fixed-function state
+
+void CachingRenderDevice::setCap(GLenum cap, bool on) {
+    const int slot = capSlot(cap);
+    const Tri want = on ? Tri::On : Tri::Off;
+    if (slot >= 0) {
+        if (m_caps[slot] == want && skip()) return;
+        m_caps[slot] = want;
+    }
+    if (on) m_inner->enable(cap);
+    else m_inner->disable(cap);
+}
+
+GLboolean CachingRenderDevice::isEnabled(GLenum cap) {
+    const int slot = capSlot(cap);
+    if (slot >= 0 && m_enabled && m_caps[slot] != Tri::Unknown) return m_caps[slot] == Tri::On ? GL_TRUE : GL_FALSE;
+    const GLboolean on = m_inner->isEnabled(cap);
+    if (slot >= 0) m_caps[slot] = on ? Tri::On : Tri::Off;
+    return on;
+}
+
+void CachingRenderDevice::blendFunc(GLenum src, GLenum dst) {
+    const std::array<GLenum, 4> f{ src, dst, src, dst };
+    if (m_blend == f && skip()) return;
+    m_blend = f;
+    m_inner->blendFunc(src, dst);
+}
+
+void CachingRenderDevice::blendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcA, GLenum dstA) {
+    const std::array<GLenum, 4> f{ srcRGB, dstRGB, srcA, dstA };
+    if (m_blend == f && skip()) return;
+    m_blend = f;
+    m_inner->blendFuncSeparate(srcRGB, dstRGB, srcA, dstA);
+}
+
+void CachingRenderDevice::depthFunc(GLenum func) {
+    if (m_depthFunc == func && skip()) return;
+    m_depthFunc = func;
+    m_inner->depthFunc(func);
+}
+
+void CachingRenderDevice::depthMask(GLboolean flag) {
+    const Tri want = flag ? Tri::On : Tri::Off;
+    if (m_depthMask == want && skip()) return;
+    m_depthMask = want;
+    m_inner->depthMask(flag);
+}
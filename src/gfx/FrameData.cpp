@@ -0,0 +1,72 @@
+#include "gfx/FrameData.hpp"
+#include "gfx/FrameStats.hpp"
+#include "gfx/RenderDevice.hpp"
+#include <algorithm>
+#include <cstring>
+#include <glm/glm.hpp>
+
+FrameDataBuffer& frameData() {
+    // Never destroyed: its buffer must be released by shutdown() while the context is alive
+    static FrameDataBuffer* g_frameData = new FrameDataBuffer;
+    return *g_frameData;
+}
+
+bool FrameDataBuffer::init() {
+    GLint align = 0;
+    device().getIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &align);
+    // Slot stride: the block rounded up to the offset alignment
+    const size_t a = std::max<size_t>(static_cast<size_t>(align), 1);
+    m_align = (sizeof(FrameDataBlock) + a - 1) / a * a;
+    m_views.clear();
+    m_bound = ~size_t(0);
+    return m_stream.init(GL_UNIFORM_BUFFER, m_align * kViewsPerFrame * kRingFrames, StreamMode::Unsynchronized);
+}
+
+void FrameDataBuffer::shutdown() {
+    m_stream.shutdown();
+    m_views.clear();
+    m_bound = ~size_t(0);
+}
+
+void FrameDataBuffer::beginFrame(int fbw, int fbh, double seconds, float dt) {
+    const float w = static_cast<float>(std::max(fbw, 1)), h = static_cast<float>(std::max(fbh, 1));
+    m_block.viewport = { w, h, 1.0f / w, 1.0f / h };
+    m_block.time = { static_cast<float>(seconds), dt, static_cast<float>(m_frame++), 0.0f };
+    fenceBound();
+    m_views.clear();
+}
+
+void FrameDataBuffer::fenceBound() {
+    if (m_bound == ~size_t(0) || m_boundFenced) return;
+    m_stream.fenceRange(m_bound, m_bound + sizeof(FrameDataBlock));
+    m_boundFenced = true;
+}
+
+void FrameDataBuffer::setView(const glm::mat4& vp) {
+    if (!m_stream.id() && !init()) return;
+
+    // Same camera again this frame (e.g. the UI and text passes): just point the block at it
+    auto it = std::find_if(m_views.begin(), m_views.end(),
+        [&vp](const View& v) { return std::memcmp(&v.vp, &vp, sizeof(vp)) == 0; });
+    if (it != m_views.end() && it->offset == m_bound) return;
+
+    // Leaving the bound slot: fence it before a write can wrap onto it
+    fenceBound();
+    size_t offset = 0;
+    if (it != m_views.end()) {
+        offset = it->offset;
+    }
+    else {
+        m_block.vp = vp;
+        m_block.invVp = glm::inverse(vp);
+        offset = m_stream.write(&m_block, sizeof(m_block), m_align);
+        frameStats().uploadBytes += sizeof(m_block);
+        // Wrapped within the frame: the older views may be overwritten next
+        if (!m_views.empty() && offset <= m_views.back().offset) m_views.clear();
+        m_views.push_back({ vp, offset });
+    }
+    device().bindBufferRange(GL_UNIFORM_BUFFER, kFrameDataBinding, m_stream.id(),
+        static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(sizeof(FrameDataBlock)));
+    m_bound = offset;
+    m_boundFenced = false;
+}
@@ -0,0 +1,53 @@
+#include "gfx/FrameStats.hpp"
+#include <ostream>
+
+namespace {
+FrameStats g_stats;
+
+// name + member, in CSV column order
+struct Field {
+    const char* name;
+    unsigned long long FrameStats::* value;
+};
+constexpr Field kFields[] = {
+    { "frame", &FrameStats::frame },
+    { "drawCalls", &FrameStats::drawCalls },
+    { "sprites", &FrameStats::sprites },
+    { "vertices", &FrameStats::vertices },
+    { "uploadBytes", &FrameStats::uploadBytes },
+    { "textureBinds", &FrameStats::textureBinds },
+    { "programBinds", &FrameStats::programBinds },
+    { "droppedSprites", &FrameStats::droppedSprites },
+    { "overflows", &FrameStats::overflows },
+    { "textureUploads", &FrameStats::textureUploads },
+    { "textureBytes", &FrameStats::textureBytes },
+    { "shaderBuilds", &FrameStats::shaderBuilds },
+    { "skippedStateCalls", &FrameStats::skippedStateCalls },
+};
+} // namespace
+
+FrameStats& frameStats() { return g_stats; }
+
+void beginFrameStats() {
+    const unsigned long long next = g_stats.frame + 1;
+    g_stats = {};
+    g_stats.frame = next;
+}
+
+void writeFrameStatsCsvHeader(std::ostream& os) {
+    const char* sep = "";
+    for (const Field& f : kFields) { os << sep << f.name; sep = ","; }
+    os << '\n';
+}
+
+void writeFrameStatsCsv(std::ostream& os, const FrameStats& s) {
+    const char* sep = "";
+    for (const Field& f : kFields) { os << sep << s.*f.value; sep = ","; }
+    os << '\n';
+}
+
+void writeFrameStatsJson(std::ostream& os, const FrameStats& s) {
+    const char* sep = "{";
+    for (const Field& f : kFields) { os << sep << '"' << f.name << "\":" << s.*f.value; sep = ","; }
+    os << "}\n";
+}
@@ -0,0 +1,296 @@
+#include "gfx/ParticleSystem.hpp"
+#include "gfx/SpriteBatch.hpp"
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#if GFX_SIMD_X86
+#include <immintrin.h>
+#endif
+
+using Streams = ParticleSystem::Streams;
+using Step = ParticleSystem::Step;
+
+// ---------------------------------------------------------------- scalar
+
+static inline void updateOne(const Step& k, const Streams& s, size_t i) {
+    const float vx = (s.vx[i] + k.gx) * k.damp;
+    const float vy = (s.vy[i] + k.gy) * k.damp;
+    s.vx[i] = vx;
+    s.vy[i] = vy;
+    s.x[i] += vx * k.dt;
+    s.y[i] += vy * k.dt;
+    const float t = std::min(s.t[i] + s.rate[i] * k.dt, 1.0f);
+    s.t[i] = t;
+    s.size[i] = k.size0 + k.sizeD * t;
+    s.r[i] = k.color0.r + k.colorD.r * t;
+    s.g[i] = k.color0.g + k.colorD.g * t;
+    s.b[i] = k.color0.b + k.colorD.b * t;
+    s.a[i] = k.color0.a + k.colorD.a * t;
+}
+
+static void updateScalar(const Step& k, const Streams& s, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) updateOne(k, s, i);
+}
+
+#if GFX_SIMD_X86
+// ---------------------------------------------------------------- SSE2
+
+GFX_TARGET_SSE2 static void updateSSE2(const Step& k, const Streams& s, size_t begin, size_t end) {
+    const __m128 dt = _mm_set1_ps(k.dt), gx = _mm_set1_ps(k.gx), gy = _mm_set1_ps(k.gy);
+    const __m128 damp = _mm_set1_ps(k.damp), one = _mm_set1_ps(1.0f);
+    const __m128 s0 = _mm_set1_ps(k.size0), sD = _mm_set1_ps(k.sizeD);
+    const __m128 r0 = _mm_set1_ps(k.color0.r), rD = _mm_set1_ps(k.colorD.r);
+    const __m128 g0 = _mm_set1_ps(k.color0.g), gD = _mm_set1_ps(k.colorD.g);
+    const __m128 b0 = _mm_set1_ps(k.color0.b), bD = _mm_set1_ps(k.colorD.b);
+    const __m128 a0 = _mm_set1_ps(k.color0.a), aD = _mm_set1_ps(k.colorD.a);
+    size_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        const __m128 vx = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(s.vx + i), gx), damp);
+        const __m128 vy = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(s.vy + i), gy), damp);
+        _mm_storeu_ps(s.vx + i, vx);
+        _mm_storeu_ps(s.vy + i, vy);
+        _mm_storeu_ps(s.x + i, _mm_add_ps(_mm_loadu_ps(s.x + i), _mm_mul_ps(vx, dt)));
+        _mm_storeu_ps(s.y + i, _mm_add_ps(_mm_loadu_ps(s.y + i), _mm_mul_ps(vy, dt)));
+        const __m128 t = _mm_min_ps(_mm_add_ps(_mm_loadu_ps(s.t + i), _mm_mul_ps(_mm_loadu_ps(s.rate + i), dt)), one);
+        _mm_storeu_ps(s.t + i, t);
+        _mm_storeu_ps(s.size + i, _mm_add_ps(s0, _mm_mul_ps(sD, t)));
+        _mm_storeu_ps(s.r + i, _mm_add_ps(r0, _mm_mul_ps(rD, t)));
+        _mm_storeu_ps(s.g + i, _mm_add_ps(g0, _mm_mul_ps(gD, t)));
+        _mm_storeu_ps(s.b + i, _mm_add_ps(b0, _mm_mul_ps(bD, t)));
+        _mm_storeu_ps(s.a + i, _mm_add_ps(a0, _mm_mul_ps(aD, t)));
+    }
+    for (; i < end; ++i) updateOne(k, s, i);
+}
+
+// ---------------------------------------------------------------- AVX2
+
+GFX_TARGET_AVX2 static void updateAVX2(const Step& k, const Streams& s, size_t begin, size_t end) {
+    const __m256 dt = _mm256_set1_ps(k.dt), gx = _mm256_set1_ps(k.gx), gy = _mm256_set1_ps(k.gy);
+    const __m256 damp = _mm256_set1_ps(k.damp), one = _mm256_set1_ps(1.0f);
+    const __m256 s0 = _mm256_set1_ps(k.size0), sD = _mm256_set1_ps(k.sizeD);
+    const __m256 r0 = _mm256_set1_ps(k.color0.r), rD = _mm256_set1_ps(k.colorD.r);
+    const __m256 g0 = _mm256_set1_ps(k.color0.g), gD = _mm256_set1_ps(k.colorD.g);
+    const __m256 b0 = _mm256_set1_ps(k.color0.b), bD = _mm256_set1_ps(k.colorD.b);
+    const __m256 a0 = _mm256_set1_ps(k.color0.a), aD = _mm256_set1_ps(k.colorD.a);
+    size_t i = begin;
+    for (; i + 8 <= end; i += 8) {
+        const __m256 vx = _mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(s.vx + i), gx), damp);
+        const __m256 vy = _mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(s.vy + i), gy), damp);
+        _mm256_storeu_ps(s.vx + i, vx);
+        _mm256_storeu_ps(s.vy + i, vy);
+        _mm256_storeu_ps(s.x + i, _mm256_add_ps(_mm256_loadu_ps(s.x + i), _mm256_mul_ps(vx, dt)));
+        _mm256_storeu_ps(s.y + i, _mm256_add_ps(_mm256_loadu_ps(s.y + i), _mm256_mul_ps(vy, dt)));
+        const __m256 t = _mm256_min_ps(_mm256_add_ps(_mm256_loadu_ps(s.t + i), _mm256_mul_ps(_mm256_loadu_ps(s.rate + i), dt)), one);
+        _mm256_storeu_ps(s.t + i, t);
+        _mm256_storeu_ps(s.size + i, _mm256_add_ps(s0, _mm256_mul_ps(sD, t)));
+        _mm256_storeu_ps(s.r + i, _mm256_add_ps(r0, _mm256_mul_ps(rD, t)));
+        _mm256_storeu_ps(s.g + i, _mm256_add_ps(g0, _mm256_mul_ps(gD, t)));
+        _mm256_storeu_ps(s.b + i, _mm256_add_ps(b0, _mm256_mul_ps(bD, t)));
+        _mm256_storeu_ps(s.a + i, _mm256_add_ps(a0, _mm256_mul_ps(aD, t)));
+    }
+    for (; i < end; ++i) updateOne(k, s, i);
+}
+#endif
+
+using UpdateKernel = void (*)(const Step&, const Streams&, size_t, size_t);
+
+static UpdateKernel updateKernel(SimdLevel level) {
+#if GFX_SIMD_X86
+    switch (level) {
+    case SimdLevel::AVX2: return updateAVX2;
+    case SimdLevel::SSE2: return updateSSE2;
+    default: break;
+    }
+#else
+    (void)level;
+#endif
+    return updateScalar;
+}
+
+// ---------------------------------------------------------------- ParticleSystem
+
+void ParticleSystem::init(size_t capacity, const ParticleParams& params, SimdLevel maxSimd) {
+    m_capacity = capacity;
+    m_count = 0;
+    m_stride = (capacity + kLineFloats - 1) & ~(kLineFloats - 1);
+    m_pool.assign(kStreams * m_stride + kLineFloats - 1, 0.0f);
+    const std::uintptr_t raw = reinterpret_cast<std::uintptr_t>(m_pool.data());
+    const std::uintptr_t line = kLineFloats * sizeof(float);
+    m_base = m_pool.data() + ((line - raw % line) % line) / sizeof(float);
+    float* p = m_base;
+    auto next = [&p, this]() { float* s = p; p += m_stride; return s; };
+    m_s.x = next();  m_s.y = next();
+    m_s.vx = next(); m_s.vy = next();
+    m_s.t = next();  m_s.rate = next();
+    m_s.size = next();
+    m_s.r = next(); m_s.g = next(); m_s.b = next(); m_s.a = next();
+
+    m_simd = resolveSimdLevel(maxSimd);
+    m_kernel = updateKernel(m_simd);
+    setParams(params);
+}
+
+float ParticleSystem::random01() {
+    // xorshift32: cheap, deterministic per system
+    m_rng ^= m_rng << 13;
+    m_rng ^= m_rng >> 17;
+    m_rng ^= m_rng << 5;
+    return static_cast<float>(m_rng >> 8) * (1.0f / 16777216.0f);
+}
+
+int ParticleSystem::emit(const ParticleBurst& b) {
+    const size_t n = std::min(static_cast<size_t>(std::max(b.count, 0)), m_capacity - m_count);
+    const glm::vec4& c = m_params.colorStart;
+    for (size_t k = 0; k < n; ++k) {
+        const size_t i = m_count++;
+        m_s.x[i] = b.pos.x + (random01() * 2.0f - 1.0f) * b.jitter.x;
+        m_s.y[i] = b.pos.y + (random01() * 2.0f - 1.0f) * b.jitter.y;
+        const float angle = b.angle + (random01() * 2.0f - 1.0f) * b.spread;
+        const float speed = b.speedMin + (b.speedMax - b.speedMin) * random01();
+        m_s.vx[i] = b.inherit.x + std::cos(angle) * speed;
+        m_s.vy[i] = b.inherit.y + std::sin(angle) * speed;
+        const float life = b.lifeMin + (b.lifeMax - b.lifeMin) * random01();
+        m_s.t[i] = 0.0f;
+        m_s.rate[i] = 1.0f / std::max(life, 1e-4f);
+        m_s.size[i] = m_params.sizeStart;
+        m_s.r[i] = c.r; m_s.g[i] = c.g; m_s.b[i] = c.b; m_s.a[i] = c.a;
+    }
+    return static_cast<int>(n);
+}
+
+// ---------------------------------------------------------------- workers
+
+// Threads 1..n-1 of a multi-threaded update (the caller runs chunk 0). Each step publishes
+// one job under the lock and bumps the generation; the workers run their chunk and the
+// caller waits until all of them have reported back.
+struct ParticleSystem::Workers {
+    using Kernel = void (*)(const Step&, const Streams&, size_t, size_t);
+
+    std::vector<std::thread> threads;
+    std::mutex m;
+    std::condition_variable wake, done;
+    std::uint64_t generation = 0;
+    bool quit = false;
+
+    // Current job; valid while pending > 0
+    Kernel kernel = nullptr;
+    const Step* step = nullptr;
+    const Streams* streams = nullptr;
+    size_t chunk = 0, count = 0;
+    size_t active = 0;  // threads taking part, the caller included
+    size_t pending = 0; // workers still running
+
+    ~Workers() {
+        {
+            std::lock_guard<std::mutex> lk(m);
+            quit = true;
+        }
+        wake.notify_all();
+        for (std::thread& t : threads) t.join();
+    }
+
+    void reserve(size_t workers) {
+        std::lock_guard<std::mutex> lk(m);
+        while (threads.size() < workers) {
+            const size_t index = threads.size() + 1;
+            threads.emplace_back(&Workers::run, this, index, generation);
+        }
+    }
+
+    void run(size_t index, std::uint64_t seen) {
+        std::unique_lock<std::mutex> lk(m);
+        for (;;) {
+            wake.wait(lk, [&] { return quit || generation != seen; });
+            if (quit) return;
+            seen = generation;
+            if (index >= active) continue; // not needed this step
+            const size_t begin = index * chunk, end = std::min(begin + chunk, count);
+            const Kernel k = kernel;
+            const Step* st = step;
+            const Streams* s = streams;
+            lk.unlock();
+            if (begin < end) k(*st, *s, begin, end);
+            lk.lock();
+            if (--pending == 0) done.notify_one();
+        }
+    }
+};
+
+ParticleSystem::ParticleSystem() = default;
+ParticleSystem::~ParticleSystem() = default;
+
+void ParticleSystem::update(float dt, int workers) {
+    if (m_count == 0 || dt <= 0.0f) return;
+
+    Step k{};
+    k.dt = dt;
+    k.gx = m_params.gravity.x * dt;
+    k.gy = m_params.gravity.y * dt;
+    k.damp = std::exp(-m_params.drag * dt);
+    k.size0 = m_params.sizeStart;
+    k.sizeD = m_params.sizeEnd - m_params.sizeStart;
+    k.color0 = m_params.colorStart;
+    k.colorD = m_params.colorEnd - m_params.colorStart;
+
+    const size_t maxWorkers = std::max<size_t>(m_count / kMinPerWorker, 1);
+    const size_t n = std::min(static_cast<size_t>(std::max(workers, 1)), maxWorkers);
+    if (n == 1) {
+        m_kernel(k, m_s, 0, m_count);
+    }
+    else {
+        // Chunks of whole cache lines: every array starts on a line, so no two threads write
+        // the same one. Rounded up from the ceiling so n chunks always cover m_count
+        const size_t chunk = ((m_count + n - 1) / n + kLineFloats - 1) & ~(kLineFloats - 1);
+        if (!m_workers) m_workers = std::make_unique<Workers>();
+        Workers& w = *m_workers;
+        w.reserve(n - 1);
+        {
+            std::lock_guard<std::mutex> lk(w.m);
+            w.kernel = m_kernel;
+            w.step = &k;
+            w.streams = &m_s;
+            w.chunk = chunk;
+            w.count = m_count;
+            w.active = n;
+            w.pending = n - 1;
+            ++w.generation;
+        }
+        w.wake.notify_all();
+        m_kernel(k, m_s, 0, std::min(chunk, m_count));
+        std::unique_lock<std::mutex> lk(w.m);
+        w.done.wait(lk, [&w] { return w.pending == 0; });
+    }
+    compact();
+}
+
+void ParticleSystem::compact() {
+    // Move the last live particle into each dead slot (order is not preserved)
+    size_t i = 0;
+    while (i < m_count) {
+        if (m_s.t[i] < 1.0f) {
+            ++i;
+            continue;
+        }
+        const size_t last = --m_count;
+        for (size_t j = 0; j < kStreams; ++j) {
+            float* f = m_base + j * m_stride;
+            f[i] = f[last];
+        }
+    }
+}
+
+void ParticleSystem::render(SpriteBatch& batch) const {
+    if (m_count == 0) return;
+
+    Sprite tmpl{};
+    tmpl.uv = m_params.uv;
+    tmpl.texture = m_params.texture;
+    tmpl.shape = m_params.shape;
+    tmpl.layer = m_params.layer;
+    const SpritePoints points{ m_s.x, m_s.y, m_s.size, m_s.r, m_s.g, m_s.b, m_s.a };
+    batch.pushPoints(points, m_count, tmpl);
+}
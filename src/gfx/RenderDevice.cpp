@@ -0,0 +1,217 @@
+#include "gfx/RenderDevice.hpp"
+#include "gfx/CachingRenderDevice.hpp"
+#include <cstdint>
+
+namespace {
+
+// Straight forwarding to the glad-loaded entry points
+class GLRenderDevice final : public RenderDevice {
+public:
+    void genBuffers(GLsizei n, GLuint* ids) override { glGenBuffers(n, ids); }
+    void deleteBuffers(GLsizei n, const GLuint* ids) override { glDeleteBuffers(n, ids); }
+    void bindBuffer(GLenum target, GLuint id) override { glBindBuffer(target, id); }
+    void bufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage) override { glBufferData(target, size, data, usage); }
+    void bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data) override { glBufferSubData(target, offset, size, data); }
+    void* mapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access) override { return glMapBufferRange(target, offset, length, access); }
+    GLboolean unmapBuffer(GLenum target) override { return glUnmapBuffer(target); }
+    void bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size) override {
+        glBindBufferRange(target, index, buffer, offset, size);
+    }
+
+    GLsync fenceSync(GLenum condition, GLbitfield flags) override { return glFenceSync(condition, flags); }
+    GLenum clientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout) override { return glClientWaitSync(sync, flags, timeout); }
+    void deleteSync(GLsync sync) override { glDeleteSync(sync); }
+
+    void genVertexArrays(GLsizei n, GLuint* ids) override { glGenVertexArrays(n, ids); }
+    void deleteVertexArrays(GLsizei n, const GLuint* ids) override { glDeleteVertexArrays(n, ids); }
+    void bindVertexArray(GLuint id) override { glBindVertexArray(id); }
+    void enableVertexAttribArray(GLuint index) override { glEnableVertexAttribArray(index); }
+    void vertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* offset) override {
+        glVertexAttribPointer(index, size, type, normalized, stride, offset);
+    }
+    void vertexAttribIPointer(GLuint index, GLint size, GLenum type, GLsizei stride, const void* offset) override {
+        glVertexAttribIPointer(index, size, type, stride, offset);
+    }
+    void vertexAttribDivisor(GLuint index, GLuint divisor) override { glVertexAttribDivisor(index, divisor); }
+
+    void genTextures(GLsizei n, GLuint* ids) override { glGenTextures(n, ids); }
+    void deleteTextures(GLsizei n, const GLuint* ids) override { glDeleteTextures(n, ids); }
+    void bindTexture(GLenum target, GLuint id) override { glBindTexture(target, id); }
+    void activeTexture(GLenum unit) override { glActiveTexture(unit); }
+    void texParameteri(GLenum target, GLenum name, GLint value) override { glTexParameteri(target, name, value); }
+    void texImage2D(GLenum target, GLint level, GLint internalFormat, GLsizei w, GLsizei h,
+        GLint border, GLenum format, GLenum type, const void* pixels) override {
+        glTexImage2D(target, level, internalFormat, w, h, border, format, type, pixels);
+    }
+    void generateMipmap(GLenum target) override { glGenerateMipmap(target); }
+    void pixelStorei(GLenum name, GLint value) override { glPixelStorei(name, value); }
+    void texBuffer(GLenum target, GLenum internalFormat, GLuint buffer) override { glTexBuffer(target, internalFormat, buffer); }
+
+    void genFramebuffers(GLsizei n, GLuint* ids) override { glGenFramebuffers(n, ids); }
+    void deleteFramebuffers(GLsizei n, const GLuint* ids) override { glDeleteFramebuffers(n, ids); }
+    void bindFramebuffer(GLenum target, GLuint id) override { glBindFramebuffer(target, id); }
+    void framebufferTexture2D(GLenum target, GLenum attachment, GLenum texTarget, GLuint tex, GLint level) override {
+        glFramebufferTexture2D(target, attachment, texTarget, tex, level);
+    }
+    GLenum checkFramebufferStatus(GLenum target) override { return glCheckFramebufferStatus(target); }
+    void genRenderbuffers(GLsizei n, GLuint* ids) override { glGenRenderbuffers(n, ids); }
+    void deleteRenderbuffers(GLsizei n, const GLuint* ids) override { glDeleteRenderbuffers(n, ids); }
+    void bindRenderbuffer(GLenum target, GLuint id) override { glBindRenderbuffer(target, id); }
+    void renderbufferStorage(GLenum target, GLenum internalFormat, GLsizei w, GLsizei h) override {
+        glRenderbufferStorage(target, internalFormat, w, h);
+    }
+    void framebufferRenderbuffer(GLenum target, GLenum attachment, GLenum rbTarget, GLuint rb) override {
+        glFramebufferRenderbuffer(target, attachment, rbTarget, rb);
+    }
+
+    GLuint createShader(GLenum type) override { return glCreateShader(type); }
+    void shaderSource(GLuint shader, GLsizei count, const GLchar* const* src, const GLint* len) override { glShaderSource(shader, count, src, len); }
+    void compileShader(GLuint shader) override { glCompileShader(shader); }
+    void getShaderiv(GLuint shader, GLenum name, GLint* out) override { glGetShaderiv(shader, name, out); }
+    void getShaderInfoLog(GLuint shader, GLsizei max, GLsizei* len, GLchar* log) override { glGetShaderInfoLog(shader, max, len, log); }
+    void deleteShader(GLuint shader) override { glDeleteShader(shader); }
+    GLuint createProgram() override { return glCreateProgram(); }
+    void attachShader(GLuint prog, GLuint shader) override { glAttachShader(prog, shader); }
+    void linkProgram(GLuint prog) override { glLinkProgram(prog); }
+    void getProgramiv(GLuint prog, GLenum name, GLint* out) override { glGetProgramiv(prog, name, out); }
+    void getProgramInfoLog(GLuint prog, GLsizei max, GLsizei* len, GLchar* log) override { glGetProgramInfoLog(prog, max, len, log); }
+    void deleteProgram(GLuint prog) override { glDeleteProgram(prog); }
+    void useProgram(GLuint prog) override { glUseProgram(prog); }
+    GLint getUniformLocation(GLuint prog, const GLchar* name) override { return glGetUniformLocation(prog, name); }
+    void uniform1i(GLint loc, GLint v) override { glUniform1i(loc, v); }
+    void uniform1iv(GLint loc, GLsizei count, const GLint* v) override { glUniform1iv(loc, count, v); }
+    void uniformMatrix4fv(GLint loc, GLsizei count, GLboolean transpose, const GLfloat* m) override { glUniformMatrix4fv(loc, count, transpose, m); }
+    GLuint getUniformBlockIndex(GLuint prog, const GLchar* name) override { return glGetUniformBlockIndex(prog, name); }
+    void uniformBlockBinding(GLuint prog, GLuint block, GLuint binding) override { glUniformBlockBinding(prog, block, binding); }
+
+    void enable(GLenum cap) override { glEnable(cap); }
+    void disable(GLenum cap) override { glDisable(cap); }
+    void blendFunc(GLenum src, GLenum dst) override { glBlendFunc(src, dst); }
+    void blendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcA, GLenum dstA) override {
+        glBlendFuncSeparate(srcRGB, dstRGB, srcA, dstA);
+    }
+    void depthFunc(GLenum func) override { glDepthFunc(func); }
+    void depthMask(GLboolean flag) override { glDepthMask(flag); }
+    void clear(GLbitfield mask) override { glClear(mask); }
+    void clearColor(GLfloat r, GLfloat g, GLfloat b, GLfloat a) override { glClearColor(r, g, b, a); }
+    void viewport(GLint x, GLint y, GLsizei w, GLsizei h) override { glViewport(x, y, w, h); }
+
+    void drawElements(GLenum mode, GLsizei count, GLenum type, const void* indices) override { glDrawElements(mode, count, type, indices); }
+    void drawElementsBaseVertex(GLenum mode, GLsizei count, GLenum type, const void* indices, GLint baseVertex) override {
+        glDrawElementsBaseVertex(mode, count, type, indices, baseVertex);
+    }
+    void drawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instances) override {
+        glDrawArraysInstanced(mode, first, count, instances);
+    }
+
+    void getIntegerv(GLenum name, GLint* out) override { glGetIntegerv(name, out); }
+    void getFloatv(GLenum name, GLfloat* out) override { glGetFloatv(name, out); }
+    GLboolean isEnabled(GLenum cap) override { return glIsEnabled(cap); }
+};
+
+GLRenderDevice g_glDevice;
+RenderDevice* g_device = &g_glDevice;
+CachingRenderDevice g_cache(&g_glDevice);
+
+} // namespace
+
+RenderDevice& device() { return g_cache; }
+
+void setRenderDevice(RenderDevice* dev) {
+    g_device = dev ? dev : &g_glDevice;
+    g_cache.setInner(g_device);
+}
+
+void setStateCaching(bool on) { g_cache.setEnabled(on); }
+
+void invalidateStateCache() { g_cache.invalidate(); }
+
+// ---------------------------------------------------------------- null
+
+void NullRenderDevice::genIds(OpKind kind, GLsizei n, GLuint* ids) {
+    count(kind);
+    for (GLsizei i = 0; i < n; ++i) ids[i] = ++m_lastId;
+}
+
+GLint NullRenderDevice::nameSlot(const GLchar* name) {
+    // Locations are per name, not per program: each distinct name gets the next index and
+    // keeps it, so different uniforms never share a location (whichever program asks)
+    const auto it = m_nameSlots.emplace(name, static_cast<GLint>(m_nameSlots.size())).first;
+    return it->second;
+}
+
+GLint NullRenderDevice::statusValue(GLenum name) {
+    // Compile/link always succeed with an empty log
+    return (name == GL_COMPILE_STATUS || name == GL_LINK_STATUS) ? GL_TRUE : 0;
+}
+
+void NullRenderDevice::bufferData(GLenum, GLsizeiptr size, const void* data, GLenum) {
+    count(OpKind::BufferUpload, data ? static_cast<size_t>(size) : 0);
+}
+
+void NullRenderDevice::bufferSubData(GLenum, GLintptr, GLsizeiptr size, const void*) {
+    count(OpKind::BufferUpload, static_cast<size_t>(size));
+}
+
+void* NullRenderDevice::mapBufferRange(GLenum, GLintptr, GLsizeiptr length, GLbitfield) {
+    // The caller memcpy()s into this just like into a real mapping
+    count(OpKind::BufferUpload, static_cast<size_t>(length));
+    if (m_mapScratch.size() < static_cast<size_t>(length)) m_mapScratch.resize(static_cast<size_t>(length));
+    return m_mapScratch.data();
+}
+
+GLsync NullRenderDevice::fenceSync(GLenum, GLbitfield) {
+    count(OpKind::Sync);
+    // Never dereferenced: only compared against nullptr and handed back to us
+    return reinterpret_cast<GLsync>(static_cast<std::uintptr_t>(++m_lastId));
+}
+
+void NullRenderDevice::texImage2D(GLenum, GLint, GLint, GLsizei w, GLsizei h, GLint, GLenum format, GLenum, const void* pixels) {
+    const size_t bpp = (format == GL_RED) ? 1 : (format == GL_RGB) ? 3 : 4;
+    count(OpKind::TextureUpload, pixels ? static_cast<size_t>(w) * static_cast<size_t>(h) * bpp : 0);
+}
+
+void NullRenderDevice::getShaderInfoLog(GLuint, GLsizei max, GLsizei* len, GLchar* log) {
+    count(OpKind::Query);
+    if (len) *len = 0;
+    if (log && max > 0) log[0] = '\0';
+}
+
+void NullRenderDevice::getProgramInfoLog(GLuint, GLsizei max, GLsizei* len, GLchar* log) {
+    count(OpKind::Query);
+    if (len) *len = 0;
+    if (log && max > 0) log[0] = '\0';
+}
+
+void NullRenderDevice::getIntegerv(GLenum name, GLint* out) {
+    count(OpKind::Query);
+    switch (name) {
+    case GL_MAX_TEXTURE_IMAGE_UNITS: *out = 16; break;   // GL 3.3 minimum
+    case GL_UNPACK_ALIGNMENT: *out = 4; break;
+    case GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT: *out = 256; break; // common desktop value
+    default: *out = 0; break;
+    }
+}
+
+void NullRenderDevice::getFloatv(GLenum name, GLfloat* out) {
+    count(OpKind::Query);
+    // Nothing is tracked, so GL's initial values: the clear color starts transparent black
+    const int n = (name == GL_COLOR_CLEAR_VALUE) ? 4 : 1;
+    for (int i = 0; i < n; ++i) out[i] = 0.0f;
+}
+
+// ---------------------------------------------------------------- recording
+
+void RecordingRenderDevice::count(OpKind kind, size_t bytes) {
+    ++m_stats.calls;
+    switch (kind) {
+    case OpKind::Create: ++m_stats.creates; break;
+    case OpKind::Bind: ++m_stats.binds; break;
+    case OpKind::BufferUpload: m_stats.bufferBytes += bytes; break;
+    case OpKind::TextureUpload: m_stats.textureBytes += bytes; break;
+    case OpKind::Sync: ++m_stats.syncs; break;
+    case OpKind::Uniform: ++m_stats.uniforms; break;
+    case OpKind::Draw: ++m_stats.draws; break;
+    default: break;
+    }
+}
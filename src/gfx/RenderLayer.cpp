@@ -0,0 +1,75 @@
+#include "gfx/RenderLayer.hpp"
+#include "gfx/RenderDevice.hpp"
+#include <iostream>
+
+bool RenderLayer::resize(int width, int height) {
+    if (width <= 0 || height <= 0) return false;
+    if (m_fbo && width == m_w && height == m_h) return true;
+    shutdown();
+    m_w = width;
+    m_h = height;
+
+    // Sampled 1:1 with the framebuffer, so nearest keeps it pixel-exact
+    device().genTextures(1, &m_tex);
+    device().bindTexture(GL_TEXTURE_2D, m_tex);
+    device().texParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    device().texParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    device().texParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    device().texParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    device().texImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+    device().genRenderbuffers(1, &m_depth);
+    device().bindRenderbuffer(GL_RENDERBUFFER, m_depth);
+    device().renderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+    device().bindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    device().genFramebuffers(1, &m_fbo);
+    device().bindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+    device().framebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_tex, 0);
+    device().framebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_depth);
+    const GLenum status = device().checkFramebufferStatus(GL_FRAMEBUFFER);
+    device().bindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "[RenderLayer] framebuffer incomplete (0x" << std::hex << status << std::dec << ")\n";
+        shutdown();
+        return false;
+    }
+    return true;
+}
+
+void RenderLayer::shutdown() {
+    if (m_fbo) device().deleteFramebuffers(1, &m_fbo), m_fbo = 0;
+    if (m_depth) device().deleteRenderbuffers(1, &m_depth), m_depth = 0;
+    if (m_tex) device().deleteTextures(1, &m_tex), m_tex = 0;
+    m_w = m_h = 0;
+    m_dirty = true;
+}
+
+void RenderLayer::beginCapture(const glm::mat4& vp) {
+    device().bindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+    device().viewport(0, 0, m_w, m_h);
+    device().getFloatv(GL_COLOR_CLEAR_VALUE, m_prevClear);
+    device().clearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    device().clear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    device().blendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    m_vp = vp;
+}
+
+void RenderLayer::endCapture(int fbw, int fbh) {
+    device().bindFramebuffer(GL_FRAMEBUFFER, 0);
+    device().viewport(0, 0, fbw, fbh);
+    device().clearColor(m_prevClear[0], m_prevClear[1], m_prevClear[2], m_prevClear[3]);
+    device().blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    m_dirty = false;
+    ++m_captures;
+}
+
+Sprite RenderLayer::sprite(const Rect2D& rect) const {
+    Sprite s{};
+    s.pos = rect.min;
+    s.size = rect.max - rect.min;
+    s.uv = { 0.0f, 0.0f, 1.0f, 1.0f }; // FBO row 0 is the bottom, like the sprite's v0
+    s.color = { 1.0f, 1.0f, 1.0f, 1.0f };
+    s.texture = m_tex;
+    return s;
+}
@@ -1,4 +1,7 @@
 #include "gfx/Shader.hpp"
+#include "gfx/FrameData.hpp"
+#include "gfx/FrameStats.hpp"
+#include "gfx/RenderDevice.hpp"
 #include <fstream>
 #include <sstream>
 #include <iostream>
@@ -16,21 +19,34 @@ bool ShaderProgram::readTextFile(const char* path, std::string& out) {
     return true;
 }
 
+void ShaderProgram::injectDefines(std::string& src, const char* defines) {
+    if (!defines || !*defines) return;
+    // #version must stay the first line, so insert right after it
+    size_t at = 0;
+    if (src.compare(0, 8, "#version") == 0) {
+        at = src.find('\n');
+        at = (at == std::string::npos) ? src.size() : at + 1;
+    }
+    std::string block(defines);
+    if (block.back() != '\n') block += '\n';
+    src.insert(at, block);
+}
+
 bool ShaderProgram::compile(GLenum type, const std::string& src, GLuint& outShader, std::string& log) {
-    outShader = glCreateShader(type);
+    outShader = device().createShader(type);
     const char* ptr = src.c_str();
-    glShaderSource(outShader, 1, &ptr, nullptr);
-    glCompileShader(outShader);
+    device().shaderSource(outShader, 1, &ptr, nullptr);
+    device().compileShader(outShader);
 
     GLint ok = GL_FALSE;
-    glGetShaderiv(outShader, GL_COMPILE_STATUS, &ok);
+    device().getShaderiv(outShader, GL_COMPILE_STATUS, &ok);
     if (!ok) {
         GLint len = 0;
-        glGetShaderiv(outShader, GL_INFO_LOG_LENGTH, &len);
+        device().getShaderiv(outShader, GL_INFO_LOG_LENGTH, &len);
         std::vector<GLchar> buf(static_cast<size_t>(len > 1 ? len : 1));
-        glGetShaderInfoLog(outShader, len, nullptr, buf.data());
+        device().getShaderInfoLog(outShader, len, nullptr, buf.data());
         log.assign(buf.begin(), buf.end());
-        glDeleteShader(outShader);
+        device().deleteShader(outShader);
         outShader = 0;
         return false;
     }
@@ -38,17 +54,17 @@ bool ShaderProgram::compile(GLenum type, const std::string& src, GLuint& outShad
 }
 
 bool ShaderProgram::link(GLuint prog, GLuint vs, GLuint fs, std::string& log) {
-    glAttachShader(prog, vs);
-    glAttachShader(prog, fs);
-    glLinkProgram(prog);
+    device().attachShader(prog, vs);
+    device().attachShader(prog, fs);
+    device().linkProgram(prog);
 
     GLint ok = GL_FALSE;
-    glGetProgramiv(prog, GL_LINK_STATUS, &ok);
+    device().getProgramiv(prog, GL_LINK_STATUS, &ok);
     if (!ok) {
         GLint len = 0;
-        glGetProgramiv(prog, GL_INFO_LOG_LENGTH, &len);
+        device().getProgramiv(prog, GL_INFO_LOG_LENGTH, &len);
         std::vector<GLchar> buf(static_cast<size_t>(len > 1 ? len : 1));
-        glGetProgramInfoLog(prog, len, nullptr, buf.data());
+        device().getProgramInfoLog(prog, len, nullptr, buf.data());
         log.assign(buf.begin(), buf.end());
         return false;
     }
@@ -56,12 +72,18 @@ bool ShaderProgram::link(GLuint prog, GLuint vs, GLuint fs, std::string& log) {
 }
 
 bool ShaderProgram::loadFromFiles(const char* vsPath, const char* fsPath) {
+    return loadFromFiles(vsPath, fsPath, nullptr);
+}
+
+bool ShaderProgram::loadFromFiles(const char* vsPath, const char* fsPath, const char* defines) {
     // Clear any previous program
     destroy();
 
     std::string vsrc, fsrc;
     if (!readTextFile(vsPath, vsrc)) return false;
     if (!readTextFile(fsPath, fsrc)) return false;
+    injectDefines(vsrc, defines);
+    injectDefines(fsrc, defines);
 
     GLuint vs = 0, fs = 0;
     std::string log;
@@ -72,29 +94,43 @@ bool ShaderProgram::loadFromFiles(const char* vsPath, const char* fsPath) {
     }
     if (!compile(GL_FRAGMENT_SHADER, fsrc, fs, log)) {
         std::cerr << "[Shader] Fragment compile error (" << fsPath << "):\n" << log << "\n";
-        if (vs) glDeleteShader(vs);
+        if (vs) device().deleteShader(vs);
         return false;
     }
 
-    m_id = glCreateProgram();
+    m_id = device().createProgram();
     if (!link(m_id, vs, fs, log)) {
         std::cerr << "[Shader] Link error:\n" << log << "\n";
-        glDeleteShader(vs);
-        glDeleteShader(fs);
-        glDeleteProgram(m_id);
+        device().deleteShader(vs);
+        device().deleteShader(fs);
+        device().deleteProgram(m_id);
         m_id = 0;
         return false;
     }
 
     // Once linked, shader objects can be deleted.
-    glDeleteShader(vs);
-    glDeleteShader(fs);
+    device().deleteShader(vs);
+    device().deleteShader(fs);
+
+    // Shared camera block (GLSL 3.30 has no layout(binding)), if this program reads it
+    const GLuint frameBlock = device().getUniformBlockIndex(m_id, "FrameData");
+    if (frameBlock != GL_INVALID_INDEX) device().uniformBlockBinding(m_id, frameBlock, kFrameDataBinding);
+    ++frameStats().shaderBuilds;
     return true;
 }
 
 void ShaderProgram::destroy() {
     if (m_id) {
-        glDeleteProgram(m_id);
+        device().deleteProgram(m_id);
         m_id = 0;
     }
+    m_locations.clear();
+}
+
+GLint ShaderProgram::uniformLocation(const char* name) const {
+    auto it = m_locations.find(name);
+    if (it != m_locations.end()) return it->second;
+    const GLint loc = device().getUniformLocation(m_id, name);
+    m_locations.emplace(name, loc);
+    return loc;
 }
@@ -0,0 +1,60 @@
+#include "gfx/Simd.hpp"
+#include <algorithm>
+
+#if GFX_SIMD_X86 && defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+static SimdLevel detectSimdLevel() {
+#if GFX_SIMD_X86 && defined(_MSC_VER)
+    int r[4] = {};
+    __cpuid(r, 0);
+    const int maxLeaf = r[0];
+
+    __cpuid(r, 1);
+    const bool sse2 = (r[3] & (1 << 26)) != 0;
+    const bool sse41 = (r[2] & (1 << 19)) != 0;
+    const bool f16c = (r[2] & (1 << 29)) != 0;
+    const bool osxsave = (r[2] & (1 << 27)) != 0;
+    const bool avx = (r[2] & (1 << 28)) != 0;
+
+    bool avx2 = false;
+    if (maxLeaf >= 7) {
+        __cpuidex(r, 7, 0);
+        avx2 = (r[1] & (1 << 5)) != 0;
+    }
+    // The OS must save YMM registers on context switch
+    const bool ymmState = osxsave && avx && ((_xgetbv(0) & 0x6) == 0x6);
+
+    if (avx2 && f16c && sse41 && ymmState) return SimdLevel::AVX2;
+    if (sse2) return SimdLevel::SSE2;
+    return SimdLevel::Scalar;
+#elif GFX_SIMD_X86 && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("f16c") && __builtin_cpu_supports("sse4.1"))
+        return SimdLevel::AVX2;
+    if (__builtin_cpu_supports("sse2")) return SimdLevel::SSE2;
+    return SimdLevel::Scalar;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+SimdLevel cpuSimdLevel() {
+    static const SimdLevel level = detectSimdLevel();
+    return level;
+}
+
+SimdLevel resolveSimdLevel(SimdLevel requested) {
+    return std::min(requested, cpuSimdLevel());
+}
+
+const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+    case SimdLevel::AVX2: return "AVX2";
+    case SimdLevel::SSE2: return "SSE2";
+    case SimdLevel::Scalar:
+    default: return "scalar";
+    }
+}
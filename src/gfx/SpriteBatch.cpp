@@ -1,6 +1,18 @@
 #include "gfx/SpriteBatch.hpp"
+#include "gfx/FrameData.hpp"
+#include "gfx/FrameStats.hpp"
+#include "gfx/RenderDevice.hpp"
+#include "gfx/StaticSpriteBatch.hpp"
+#include "gfx/Texture2D.hpp"
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <condition_variable>
+#include <cstring>
 #include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp> // ortho
@@ -8,68 +20,158 @@
 
 #include "thirdparty/stb_image.h"
 
+// LSD radix sort on 64-bit keys, 8 bits per pass. Stable, so equal keys keep push order.
+// Passes where every key has the same byte are skipped (common: unused layers, one texture).
+void SpriteBatch::radixSort(std::vector<SortEntry>& a, std::vector<SortEntry>& tmp) {
+    const size_t n = a.size();
+    if (n < 2) return;
+    tmp.resize(n);
+
+    for (int shift = 0; shift < 64; shift += 8) {
+        size_t count[256] = {};
+        for (const auto& e : a) ++count[(e.key >> shift) & 0xFF];
+        if (count[(a[0].key >> shift) & 0xFF] == n) continue;
+
+        size_t sum = 0;
+        for (size_t& c : count) { size_t t = c; c = sum; sum += t; }
+        for (const auto& e : a) tmp[count[(e.key >> shift) & 0xFF]++] = e;
+        a.swap(tmp);
+    }
+}
+
+// A 16-bit table addresses 65536 vertices; longer runs are drawn in chunks of this many
+// quads, each with its own base vertex
+static constexpr int kU16Quads = 65536 / 4;
+
+// Two triangles per quad over corners BL, BR, TL, TR: [0..3] for each sprite
+template <typename Index>
+static void fillQuadIndices(Index* dst, size_t sprites) {
+    for (size_t i = 0; i < sprites; ++i, dst += 6) {
+        const Index baseV = static_cast<Index>(i * 4);
+        dst[0] = static_cast<Index>(baseV + 0);
+        dst[1] = static_cast<Index>(baseV + 1);
+        dst[2] = static_cast<Index>(baseV + 2);
+        dst[3] = static_cast<Index>(baseV + 2);
+        dst[4] = static_cast<Index>(baseV + 1);
+        dst[5] = static_cast<Index>(baseV + 3);
+    }
+}
+
+// Builds the table for 'quads' sprites in a temporary and uploads it to the bound
+// GL_ELEMENT_ARRAY_BUFFER; nothing stays resident on the CPU. Returns the bytes sent.
+static size_t uploadQuadIndices(GLenum type, size_t quads) {
+    if (type == GL_UNSIGNED_SHORT) {
+        quads = std::min(quads, static_cast<size_t>(kU16Quads));
+        std::vector<std::uint16_t> idx(quads * 6);
+        fillQuadIndices(idx.data(), quads);
+        device().bufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(idx.size() * sizeof(std::uint16_t)), idx.data(), GL_STATIC_DRAW);
+        return idx.size() * sizeof(std::uint16_t);
+    }
+    std::vector<std::uint32_t> idx(quads * 6);
+    fillQuadIndices(idx.data(), quads);
+    device().bufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(idx.size() * sizeof(std::uint32_t)), idx.data(), GL_STATIC_DRAW);
+    return idx.size() * sizeof(std::uint32_t);
+}
+
+// Order-preserving float -> uint (negative values sort below positive ones)
+static inline std::uint32_t sortableFloat(float f) {
+    std::uint32_t u;
+    std::memcpy(&u, &f, sizeof(u));
+    return (u & 0x80000000u) ? ~u : (u | 0x80000000u);
+}
+
+// Sample mode in flags bits 4-7 (sprite_batch.frag picks it per sprite, no uniform)
+static inline std::uint32_t modeBits(int mode) {
+    return static_cast<std::uint32_t>(mode & 0xF) << 4;
+}
+
 bool SpriteBatch::init(const char* vsPath, const char* fsPath,
     const char* texturePath, int maxSprites) {
-    m_maxSprites = maxSprites;
+    SpriteBatchOptions opt;
+    opt.maxSprites = maxSprites;
+    return init(vsPath, fsPath, texturePath, opt);
+}
+
+// Index of word in a draw's shape table (entry 0 = Quad), added if missing; -1 when full.
+// Words stay below 2^26, so they pass through the int uniform unchanged.
+static int shapeIndex(GLint* table, int& count, std::uint32_t word) {
+    if (word == 0) return 0;
+    const GLint w = static_cast<GLint>(word);
+    for (int i = 1; i < count; ++i) {
+        if (table[i] == w) return i;
+    }
+    if (count == SpriteBatch::kMaxShapes) return -1;
+    table[count] = w;
+    return count++;
+}
+
+bool SpriteBatch::init(const char* vsPath, const char* fsPath,
+    const char* texturePath, const SpriteBatchOptions& opt) {
+    m_opt = opt;
+    m_opt.ringFlushes = std::max(1, m_opt.ringFlushes);
+    m_maxSprites = std::max(1, m_opt.maxSprites);
     m_spriteCount = 0;
 
-    // 1) Program + uniforms
-    if (!m_prog.loadFromFiles(vsPath, fsPath)) return false;
-    m_uP = m_prog.uniformLocation("u_P");
+    // CPU expansion kernels for the best tier this machine allows
+    m_simd = resolveSimdLevel(m_opt.maxSimd);
+    m_kernels = &spriteKernels(m_simd);
+
+    // Texture slots: GL 3.3 guarantees 16 fragment units
+    GLint maxUnits = 16;
+    device().getIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &maxUnits);
+    m_maxSlots = std::clamp(m_opt.maxTextures, 1, std::min<int>(maxUnits, kMaxTextureSlots));
+    m_slotCount = 0;
+    m_shapeCount = 1;
+    m_lastShape = 0;
+
+    // 1) Program + uniforms (same shader files, variants are #defines)
+    std::string defines = "#define SPRITE_MAX_TEXTURES " + std::to_string(m_maxSlots) + "\n";
+    defines += "#define SPRITE_MAX_SHAPES " + std::to_string(kMaxShapes) + "\n";
+    if (m_opt.submit == SpriteSubmit::Instanced) defines += "#define SPRITE_INSTANCED\n";
+    if (m_opt.submit == SpriteSubmit::Pulled) defines += "#define SPRITE_PULLED\n";
+    if (!m_prog.loadFromFiles(vsPath, fsPath, defines.c_str())) return false;
+    m_uRecords = m_prog.uniformLocation("u_Records");
     m_uTex = m_prog.uniformLocation("uTex");
-    m_uMode = m_prog.uniformLocation("u_Mode");
+    m_uShapes = m_prog.uniformLocation("u_Shapes"); // vertex paths only
 
     // 2) CPU buffers sized to capacity
-    m_cpuVerts.resize(static_cast<size_t>(m_maxSprites) * 4);
-    m_cpuIndices.resize(static_cast<size_t>(m_maxSprites) * 6);
-
-    // Precompute EBO indices once: [0..3] for each sprite
-    for (int i = 0; i < m_maxSprites; ++i) {
-        unsigned int baseV = static_cast<unsigned int>(i) * 4u;
-        unsigned int baseI = static_cast<unsigned int>(i) * 6u;
-        m_cpuIndices[baseI + 0] = baseV + 0;
-        m_cpuIndices[baseI + 1] = baseV + 1;
-        m_cpuIndices[baseI + 2] = baseV + 2;
-        m_cpuIndices[baseI + 3] = baseV + 2;
-        m_cpuIndices[baseI + 4] = baseV + 1;
-        m_cpuIndices[baseI + 5] = baseV + 3;
-    }
+    resizeStaging();
 
     // 3) GL objects
-    glGenVertexArrays(1, &m_vao);
-    glGenBuffers(1, &m_vbo);
-    glGenBuffers(1, &m_ebo);
-
-    glBindVertexArray(m_vao);
-
-    // VBO: allocate enough for maxSprites * 4 vertices (dynamic)
-    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-    glBufferData(GL_ARRAY_BUFFER,
-        static_cast<GLsizeiptr>(m_cpuVerts.size() * sizeof(Vertex)),
-        nullptr, // no data yet
-        GL_DYNAMIC_DRAW);
-
-    // EBO: upload static index table
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER,
-        static_cast<GLsizeiptr>(m_cpuIndices.size() * sizeof(unsigned int)),
-        m_cpuIndices.data(),
-        GL_STATIC_DRAW);
-
-    // Vertex layout: pos(2), uv(2), color(4)  all floats
-    const GLsizei stride = static_cast<GLsizei>(sizeof(Vertex));
-    // aPos
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<void*>(offsetof(Vertex, x)));
-    // aUV
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<void*>(offsetof(Vertex, u)));
-    // aColor
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<void*>(offsetof(Vertex, r)));
+    device().genVertexArrays(1, &m_vao);
+    device().bindVertexArray(m_vao);
 
-    glBindVertexArray(0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    // VBO: ring of ringFlushes * (maxSprites worth of data); a single flush in SubData mode
+    if (!m_stream.init(GL_ARRAY_BUFFER, ringBytes(), m_opt.stream))
+        return false;
+
+    if (m_opt.submit == SpriteSubmit::Instanced) {
+        // Attributes are pointed at the ring region on every flush
+        pointInstanceAttribs(0);
+    }
+    else {
+        // EBO: upload static index table
+        device().genBuffers(1, &m_ebo);
+        uploadIndices();
+        if (m_opt.submit == SpriteSubmit::Pulled) {
+            // No attributes: the shader fetches records from the ring through a buffer texture
+            device().genTextures(1, &m_recordTex);
+            device().bindTexture(GL_TEXTURE_BUFFER, m_recordTex);
+            device().texBuffer(GL_TEXTURE_BUFFER, GL_RGBA32UI, m_stream.id());
+            device().bindTexture(GL_TEXTURE_BUFFER, 0);
+            GLint maxTexels = 0;
+            device().getIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &maxTexels);
+            if (maxTexels > 0 && ringBytes() / 16 > static_cast<size_t>(maxTexels))
+                std::cerr << "[SpriteBatch] ring of " << ringBytes() / 16 << " texels exceeds GL_MAX_TEXTURE_BUFFER_SIZE ("
+                    << maxTexels << "); lower maxSprites or ringFlushes\n";
+        }
+        else {
+            setupVertexLayout(m_stream.id());
+        }
+    }
+
+    device().bindVertexArray(0);
+    device().bindBuffer(GL_ARRAY_BUFFER, 0);
 
     // 4) Texture
     if (!loadTexture(texturePath)) return false;
@@ -77,6 +179,197 @@ bool SpriteBatch::init(const char* vsPath, const char* fsPath,
     return true;
 }
 
+size_t SpriteBatch::vertexSize() const {
+    return (m_opt.submit == SpriteSubmit::PackedVertices) ? sizeof(PackedVertex) : sizeof(Vertex);
+}
+
+bool SpriteBatch::recordPerSprite() const {
+    return m_opt.submit == SpriteSubmit::Instanced || m_opt.submit == SpriteSubmit::Pulled;
+}
+
+size_t SpriteBatch::bytesPerSprite() const {
+    return recordPerSprite() ? sizeof(Instance) : 4 * vertexSize();
+}
+
+size_t SpriteBatch::ringBytes() const {
+    const int flushes = (m_opt.stream == StreamMode::SubData) ? 1 : m_opt.ringFlushes;
+    return bytesPerSprite() * static_cast<size_t>(m_maxSprites) * static_cast<size_t>(flushes);
+}
+
+void SpriteBatch::resizeStaging() {
+    // resize() keeps what is already queued, so this is also safe mid-batch (Grow)
+    if (recordPerSprite()) {
+        m_cpuInstances.resize(static_cast<size_t>(m_maxSprites));
+        return;
+    }
+
+    if (m_opt.submit == SpriteSubmit::PackedVertices) m_cpuPacked.resize(static_cast<size_t>(m_maxSprites) * 4);
+    else m_cpuVerts.resize(static_cast<size_t>(m_maxSprites) * 4);
+}
+
+GLenum SpriteBatch::indexType() const {
+    return (m_opt.indices == SpriteIndexType::U16) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+}
+
+void SpriteBatch::uploadIndices() {
+    // Element buffer binding is VAO state, so the VAO must be bound here
+    device().bindVertexArray(m_vao);
+    device().bindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
+    frameStats().uploadBytes += uploadQuadIndices(indexType(), static_cast<size_t>(m_maxSprites));
+    m_indexedQuads = m_maxSprites;
+}
+
+void SpriteBatch::drawQuads(GLenum type, GLint baseVertex, int quads) {
+    // 16-bit: the table holds at most kU16Quads, so walk the range in base-vertex chunks
+    const int chunk = (type == GL_UNSIGNED_SHORT) ? kU16Quads : quads;
+    for (int done = 0; done < quads; done += chunk) {
+        const int n = std::min(chunk, quads - done);
+        device().drawElementsBaseVertex(GL_TRIANGLES, n * 6, type, nullptr, baseVertex + done * 4);
+        ++frameStats().drawCalls;
+    }
+}
+
+bool SpriteBatch::makeRoom() {
+    ++m_overflows;
+    ++frameStats().overflows;
+    switch (m_opt.overflow) {
+    case SpriteOverflow::Flush:
+        flush();
+        return true;
+    case SpriteOverflow::Grow:
+        if (m_maxSprites < m_opt.growLimit) {
+            grow(std::min(m_maxSprites * 2, m_opt.growLimit));
+            return true;
+        }
+        flush(); // at the cap: keep drawing rather than lose sprites
+        return true;
+    case SpriteOverflow::Drop:
+    default:
+        ++m_dropped;
+        ++frameStats().droppedSprites;
+        return false;
+    }
+}
+
+int SpriteBatch::findSlot(GLuint tex) const {
+    for (int i = 0; i < m_slotCount; ++i) {
+        if (m_slots[i] == tex) return i;
+    }
+    return -1;
+}
+
+unsigned int SpriteBatch::slotFor(GLuint tex) {
+    // Consecutive sprites usually share a texture
+    if (static_cast<int>(m_lastSlot) < m_slotCount && m_slots[m_lastSlot] == tex) return m_lastSlot;
+
+    const int found = findSlot(tex);
+    if (found >= 0) return m_lastSlot = static_cast<unsigned int>(found);
+
+    if (m_slotCount == m_maxSlots) {
+        ++m_textureBreaks;
+        flush(); // frees every slot
+    }
+    m_slots[m_slotCount] = tex;
+    return m_lastSlot = static_cast<unsigned int>(m_slotCount++);
+}
+
+int SpriteBatch::addShape(std::uint32_t word) {
+    // Like textures, consecutive sprites usually share a shape
+    if (word == 0) return 0;
+    if (m_lastShape < m_shapeCount && m_shapes[m_lastShape] == static_cast<GLint>(word)) return m_lastShape;
+    const int i = shapeIndex(m_shapes.data(), m_shapeCount, word);
+    if (i > 0) m_lastShape = i;
+    return i;
+}
+
+void SpriteBatch::uploadShapes(const GLint* shapes, int count) {
+    // Only the used prefix; entry 0 is always 0, so a table of plain quads sends nothing
+    if (m_uShapes != -1 && count > 1) device().uniform1iv(m_uShapes, count, shapes);
+}
+
+void SpriteBatch::grow(int maxSprites) {
+    m_maxSprites = maxSprites;
+    ++m_grows;
+    resizeStaging();
+    m_stream.resize(ringBytes());
+    m_last.count = 0; // the ring contents are gone
+    // The 16-bit table stops growing at kU16Quads (chunked draws cover the rest)
+    const bool moreIndices = (m_opt.indices == SpriteIndexType::U32) || (m_indexedQuads < kU16Quads);
+    if (m_opt.submit != SpriteSubmit::Instanced && moreIndices) {
+        uploadIndices();
+        device().bindVertexArray(0);
+    }
+}
+
+void SpriteBatch::setupVertexLayout(GLuint vbo) {
+    if (m_opt.submit == SpriteSubmit::PackedVertices) {
+        // Same attribute slots as below; GL converts to float, so the shader is unchanged
+        device().bindBuffer(GL_ARRAY_BUFFER, vbo);
+        const GLsizei pstride = static_cast<GLsizei>(sizeof(PackedVertex));
+        device().enableVertexAttribArray(0);
+        device().vertexAttribPointer(0, 2, GL_HALF_FLOAT, GL_FALSE, pstride, reinterpret_cast<void*>(offsetof(PackedVertex, xy)));
+        device().enableVertexAttribArray(1);
+        device().vertexAttribPointer(1, 2, GL_UNSIGNED_SHORT, GL_TRUE, pstride, reinterpret_cast<void*>(offsetof(PackedVertex, uv)));
+        device().enableVertexAttribArray(2);
+        device().vertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, pstride, reinterpret_cast<void*>(offsetof(PackedVertex, rgba)));
+        device().enableVertexAttribArray(3);
+        device().vertexAttribIPointer(3, 1, GL_UNSIGNED_INT, pstride, reinterpret_cast<void*>(offsetof(PackedVertex, flags)));
+        return;
+    }
+
+    // Vertex layout (attributes read from vbo): pos(2), uv(2), color(4) floats + flags(uint)
+    device().bindBuffer(GL_ARRAY_BUFFER, vbo);
+    const GLsizei stride = static_cast<GLsizei>(sizeof(Vertex));
+    // aPos
+    device().enableVertexAttribArray(0);
+    device().vertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<void*>(offsetof(Vertex, x)));
+    // aUV
+    device().enableVertexAttribArray(1);
+    device().vertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<void*>(offsetof(Vertex, u)));
+    // aColor
+    device().enableVertexAttribArray(2);
+    device().vertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<void*>(offsetof(Vertex, r)));
+    // aFlags (integer attribute, not normalized)
+    device().enableVertexAttribArray(3);
+    device().vertexAttribIPointer(3, 1, GL_UNSIGNED_INT, stride, reinterpret_cast<void*>(offsetof(Vertex, flags)));
+}
+
+void SpriteBatch::pointInstanceAttribs(size_t offset) {
+    // Instance layout: posSize(4 floats), uv(unorm16x4), color(RGBA8 normalized), flags(uint),
+    // rotation(float), pivot(unorm16x2), shape(uint); divisor 1.
+    // Expects the VAO and the source buffer (ring or static) to be bound.
+    const GLsizei stride = static_cast<GLsizei>(sizeof(Instance));
+    auto at = [offset](size_t field) { return reinterpret_cast<void*>(offset + field); };
+    // iPosSize
+    device().enableVertexAttribArray(0);
+    device().vertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, stride, at(offsetof(Instance, x)));
+    device().vertexAttribDivisor(0, 1);
+    // iUV
+    device().enableVertexAttribArray(1);
+    device().vertexAttribPointer(1, 4, GL_UNSIGNED_SHORT, GL_TRUE, stride, at(offsetof(Instance, uv0)));
+    device().vertexAttribDivisor(1, 1);
+    // iColor
+    device().enableVertexAttribArray(2);
+    device().vertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, at(offsetof(Instance, rgba)));
+    device().vertexAttribDivisor(2, 1);
+    // iFlags
+    device().enableVertexAttribArray(3);
+    device().vertexAttribIPointer(3, 1, GL_UNSIGNED_INT, stride, at(offsetof(Instance, flags)));
+    device().vertexAttribDivisor(3, 1);
+    // iRot
+    device().enableVertexAttribArray(4);
+    device().vertexAttribPointer(4, 1, GL_FLOAT, GL_FALSE, stride, at(offsetof(Instance, rotation)));
+    device().vertexAttribDivisor(4, 1);
+    // iPivot
+    device().enableVertexAttribArray(5);
+    device().vertexAttribPointer(5, 2, GL_UNSIGNED_SHORT, GL_TRUE, stride, at(offsetof(Instance, pivot)));
+    device().vertexAttribDivisor(5, 1);
+    // iShape
+    device().enableVertexAttribArray(6);
+    device().vertexAttribIPointer(6, 1, GL_UNSIGNED_INT, stride, at(offsetof(Instance, shape)));
+    device().vertexAttribDivisor(6, 1);
+}
+
 bool SpriteBatch::loadTexture(const char* path) {
     int w = 0, h = 0, comp = 0;
     stbi_set_flip_vertically_on_load(true);
@@ -87,95 +380,734 @@ bool SpriteBatch::loadTexture(const char* path) {
     }
 
     GLenum format = (comp == 4) ? GL_RGBA : (comp == 3) ? GL_RGB : GL_RED;
+    const bool opaque = alphaIsOpaque(pixels, w, h, comp);
 
     GLint prevUnpack = 0;
-    glGetIntegerv(GL_UNPACK_ALIGNMENT, &prevUnpack);
-    if ((w * comp) % 4 != 0) glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    device().getIntegerv(GL_UNPACK_ALIGNMENT, &prevUnpack);
+    if ((w * comp) % 4 != 0) device().pixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
-    glGenTextures(1, &m_tex);
-    glBindTexture(GL_TEXTURE_2D, m_tex);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    device().genTextures(1, &m_tex);
+    device().bindTexture(GL_TEXTURE_2D, m_tex);
+    device().texParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    device().texParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    device().texParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    device().texParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
-    glTexImage2D(GL_TEXTURE_2D, 0,
+    device().texImage2D(GL_TEXTURE_2D, 0,
         (format == GL_RGBA) ? GL_RGBA8 : (format == GL_RGB) ? GL_RGB8 : GL_R8,
         w, h, 0, format, GL_UNSIGNED_BYTE, pixels);
-    glGenerateMipmap(GL_TEXTURE_2D);
+    device().generateMipmap(GL_TEXTURE_2D);
 
-    if ((w * comp) % 4 != 0) glPixelStorei(GL_UNPACK_ALIGNMENT, prevUnpack);
+    if ((w * comp) % 4 != 0) device().pixelStorei(GL_UNPACK_ALIGNMENT, prevUnpack);
 
+    ++frameStats().textureUploads;
+    frameStats().textureBytes += static_cast<unsigned long long>(w) * h * comp;
     stbi_image_free(pixels);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    device().bindTexture(GL_TEXTURE_2D, 0);
+    setTextureOpaque(m_tex, opaque);
     return true;
 }
 
 void SpriteBatch::shutdown() {
-    if (m_tex) glDeleteTextures(1, &m_tex), m_tex = 0;
-    if (m_ebo) glDeleteBuffers(1, &m_ebo), m_ebo = 0;
-    if (m_vbo) glDeleteBuffers(1, &m_vbo), m_vbo = 0;
-    if (m_vao) glDeleteVertexArrays(1, &m_vao), m_vao = 0;
+    if (m_tex) device().deleteTextures(1, &m_tex), m_tex = 0;
+    if (m_ebo) device().deleteBuffers(1, &m_ebo), m_ebo = 0;
+    if (m_recordTex) device().deleteTextures(1, &m_recordTex), m_recordTex = 0;
+    m_stream.shutdown();
+    m_last = {};
+    m_opaqueTextures.clear();
+    if (m_vao) device().deleteVertexArrays(1, &m_vao), m_vao = 0;
     m_prog.destroy();
 }
 
 void SpriteBatch::begin(int fbw, int fbh) {
     m_spriteCount = 0;
+    m_slotCount = 0;
+    m_deferred.clear();
 
-    // Set projection once per frame
+    // Pixel projection as the current FrameData view (uploaded once per frame)
     m_prog.use();
-    if (m_uP != -1) {
-        glm::mat4 P = glm::ortho(0.0f, float(fbw), 0.0f, float(fbh), -1.0f, 1.0f);
-        glUniformMatrix4fv(m_uP, 1, GL_FALSE, glm::value_ptr(P));
-    }
-    // Bind sampler to unit 0
-    if (m_uTex != -1) glUniform1i(m_uTex, 0);
+    frameData().setView(glm::ortho(0.0f, float(fbw), 0.0f, float(fbh), -1.0f, 1.0f));
+    bindSamplerUnits();
 }
 
 void SpriteBatch::push(const Sprite& s) {
-    if (m_spriteCount >= m_maxSprites) return; // silently drop if overflow (or grow)
+    if (deferred()) {
+        // Resolve the batch texture now; setTexture() may change before endAndDraw
+        DeferredSprite d{ s, m_mode };
+        if (!d.sprite.texture) d.sprite.texture = m_tex;
+        m_deferred.push_back(d);
+        return;
+    }
+    emit(s, m_mode);
+}
+
+void SpriteBatch::emit(const Sprite& s, int mode, std::uint32_t depthBits) {
+    if (m_spriteCount >= m_maxSprites && !makeRoom()) return; // Drop policy
+
+    // Room in both tables first, so slotFor cannot flush the shape entry away (or the reverse)
+    const GLuint tex = s.texture ? s.texture : m_tex;
+    const std::uint32_t word = vertexShapes() ? packSpriteShape(s) : 0u;
+    if ((findSlot(tex) < 0 && m_slotCount == m_maxSlots) || addShape(word) < 0) {
+        ++m_textureBreaks;
+        flush(); // frees every slot and shape
+    }
+    const std::uint32_t shape = static_cast<std::uint32_t>(addShape(word)) << 8;
+    const std::uint32_t flags = slotFor(tex) | shape | modeBits(mode) | depthBits;
+    expand(&s, &flags, 1);
+}
 
-    const unsigned int i = static_cast<unsigned int>(m_spriteCount);
-    const float x = s.pos.x;
-    const float y = s.pos.y;
-    const float w = s.size.x;
-    const float h = s.size.y;
+void SpriteBatch::pushMany(std::span<const Sprite> sprites) {
+    if (deferred()) {
+        for (const Sprite& s : sprites) push(s);
+        return;
+    }
 
-    const float u0 = s.uv.x, v0 = s.uv.y, u1 = s.uv.z, v1 = s.uv.w;
-    const float r = s.color.r, g = s.color.g, b = s.color.b, a = s.color.a;
+    const std::uint32_t mode = modeBits(m_mode);
+    const bool shapes = vertexShapes();
+    const Sprite* s = sprites.data();
+    size_t left = sprites.size();
+    while (left > 0) {
+        if (m_spriteCount >= m_maxSprites && !makeRoom()) {
+            m_dropped += left - 1; // makeRoom() already counted the first one
+            frameStats().droppedSprites += left - 1;
+            return;
+        }
 
-    // 4 vertices for this sprite in CPU buffer
-    Vertex* v = &m_cpuVerts[i * 4u];
-    // bottom-left
-    v[0] = { x,     y,     u0, v0, r, g, b, a };
-    // bottom-right
-    v[1] = { x + w, y,     u1, v0, r, g, b, a };
-    // top-left
-    v[2] = { x,     y + h, u0, v1, r, g, b, a };
-    // top-right
-    v[3] = { x + w, y + h, u1, v1, r, g, b, a };
+        // Longest run that fits the remaining capacity, the free texture slots and shape entries
+        const size_t room = std::min(left, static_cast<size_t>(m_maxSprites - m_spriteCount));
+        m_flagScratch.resize(room);
+        size_t run = 0;
+        for (; run < room; ++run) {
+            const GLuint tex = s[run].texture ? s[run].texture : m_tex;
+            int slot = findSlot(tex);
+            if (slot < 0 && m_slotCount == m_maxSlots) break;
+            const int shape = shapes ? addShape(packSpriteShape(s[run])) : 0;
+            if (shape < 0) break;
+            if (slot < 0) {
+                m_slots[m_slotCount] = tex;
+                slot = m_slotCount++;
+            }
+            m_flagScratch[run] = static_cast<std::uint32_t>(slot) | static_cast<std::uint32_t>(shape) << 8 | mode;
+        }
+        if (run == 0) {
+            ++m_textureBreaks;
+            flush(); // frees every slot and shape
+            continue;
+        }
 
-    ++m_spriteCount;
+        expand(s, m_flagScratch.data(), run);
+        s += run;
+        left -= run;
+    }
+}
+
+void SpriteBatch::pushPoints(const SpritePoints& p, size_t n, const Sprite& tmpl) {
+    if (deferred()) {
+        Sprite s = tmpl;
+        s.rotation = 0.0f;
+        for (size_t i = 0; i < n; ++i) {
+            s.pos = { p.x[i] - 0.5f * p.size[i], p.y[i] - 0.5f * p.size[i] };
+            s.size = { p.size[i], p.size[i] };
+            s.color = { p.r[i], p.g[i], p.b[i], p.a[i] };
+            push(s);
+        }
+        return;
+    }
+
+    const GLuint tex = tmpl.texture ? tmpl.texture : m_tex;
+    const bool shapes = vertexShapes() && tmpl.shape != SpriteShape::Quad;
+    const std::uint32_t mode = modeBits(m_mode);
+    size_t done = 0;
+    while (done < n) {
+        if (m_spriteCount >= m_maxSprites && !makeRoom()) {
+            m_dropped += n - done - 1; // makeRoom() already counted the first one
+            frameStats().droppedSprites += n - done - 1;
+            return;
+        }
+
+        // Same run rules as pushMany; only the shape word (it scales with the size) varies
+        int slot = findSlot(tex);
+        const size_t room = std::min(n - done, static_cast<size_t>(m_maxSprites - m_spriteCount));
+        m_flagScratch.resize(room);
+        size_t run = 0;
+        if (slot >= 0 || m_slotCount < m_maxSlots) {
+            for (; run < room; ++run) {
+                const float size = p.size[done + run];
+                const int shape = shapes ? addShape(packSpriteShape(tmpl, { size, size })) : 0;
+                if (shape < 0) break;
+                m_flagScratch[run] = static_cast<std::uint32_t>(shape) << 8 | mode;
+            }
+        }
+        if (run == 0) {
+            ++m_textureBreaks;
+            flush(); // frees every slot and shape
+            continue;
+        }
+        if (slot < 0) {
+            m_slots[m_slotCount] = tex;
+            slot = m_slotCount++;
+        }
+        for (size_t k = 0; k < run; ++k) m_flagScratch[k] |= static_cast<std::uint32_t>(slot);
+
+        const size_t i = static_cast<size_t>(m_spriteCount);
+        switch (m_opt.submit) {
+        case SpriteSubmit::Instanced:
+        case SpriteSubmit::Pulled:
+            m_kernels->pointInstances(p, done, run, tmpl, m_flagScratch.data(), &m_cpuInstances[i]);
+            break;
+        case SpriteSubmit::PackedVertices:
+            m_kernels->pointPacked(p, done, run, tmpl, m_flagScratch.data(), &m_cpuPacked[i * 4]);
+            break;
+        case SpriteSubmit::Vertices:
+        default:
+            m_kernels->pointVertices(p, done, run, tmpl, m_flagScratch.data(), &m_cpuVerts[i * 4]);
+            break;
+        }
+        m_spriteCount += static_cast<int>(run);
+        done += run;
+    }
+}
+
+// Threads 1..n-1 of a parallel pushRecorded (the caller is thread 0). Each call publishes
+// the job count and bumps the generation; every thread then claims recorders from a shared
+// counter until none are left, and the caller waits until the workers have reported back.
+struct SpriteBatch::RecordWorkers {
+    std::vector<std::thread> threads;
+    std::mutex m;
+    std::condition_variable wake, done;
+    std::uint64_t generation = 0;
+    bool quit = false;
+
+    // Current call; valid while pending > 0
+    SpriteBatch* batch = nullptr;
+    std::atomic<size_t> next{ 0 };
+    size_t jobs = 0;
+    size_t active = 0;  // threads taking part, the caller included
+    size_t pending = 0; // workers still running
+
+    ~RecordWorkers() {
+        {
+            std::lock_guard<std::mutex> lk(m);
+            quit = true;
+        }
+        wake.notify_all();
+        for (std::thread& t : threads) t.join();
+    }
+
+    void reserve(size_t workers) {
+        std::lock_guard<std::mutex> lk(m);
+        while (threads.size() < workers) {
+            const size_t index = threads.size() + 1;
+            threads.emplace_back(&RecordWorkers::run, this, index, generation);
+        }
+    }
+
+    void claim(SpriteBatch& b) {
+        for (size_t j = next.fetch_add(1); j < jobs; j = next.fetch_add(1)) b.expandRecorded(j);
+    }
+
+    void run(size_t index, std::uint64_t seen) {
+        std::unique_lock<std::mutex> lk(m);
+        for (;;) {
+            wake.wait(lk, [&] { return quit || generation != seen; });
+            if (quit) return;
+            seen = generation;
+            if (index >= active) continue; // not needed this call
+            SpriteBatch* b = batch;
+            lk.unlock();
+            claim(*b);
+            lk.lock();
+            if (--pending == 0) done.notify_one();
+        }
+    }
+};
+
+SpriteBatch::SpriteBatch() = default;
+SpriteBatch::~SpriteBatch() = default;
+
+void SpriteBatch::pushRecorded(std::span<const SpriteRecorder> recorders, int workers) {
+    // Sizes are known up front, so reserve once instead of reallocating/doubling mid-merge
+    size_t total = 0;
+    for (const SpriteRecorder& r : recorders) total += r.size();
+    if (total == 0) return;
+
+    if (deferred()) {
+        m_deferred.reserve(m_deferred.size() + total);
+    }
+    else {
+        if (m_opt.overflow == SpriteOverflow::Grow) {
+            const size_t want = static_cast<size_t>(m_spriteCount) + total;
+            int cap = m_maxSprites;
+            while (static_cast<size_t>(cap) < want && cap < m_opt.growLimit)
+                cap = std::min(cap * 2, m_opt.growLimit);
+            if (cap != m_maxSprites) grow(cap);
+        }
+
+        // All of it in this flush (or the next, if what is queued is in the way): the tables
+        // are filled once here, so the recorders no longer depend on each other
+        auto fits = [&] {
+            return static_cast<size_t>(m_spriteCount) + total <= static_cast<size_t>(m_maxSprites) &&
+                claimRecorded(recorders);
+        };
+        bool parallel = fits();
+        if (!parallel && m_spriteCount > 0) {
+            flush();
+            parallel = fits();
+        }
+        if (parallel) {
+            // Prefix offsets: recorder k expands into [first_k, first_k + size_k)
+            m_recordBase = static_cast<size_t>(m_spriteCount);
+            m_recordJobs.clear();
+            size_t first = m_recordBase;
+            for (const SpriteRecorder& r : recorders) {
+                if (!r.empty()) m_recordJobs.push_back({ &r, first });
+                first += r.size();
+            }
+            m_flagScratch.resize(total);
+
+            const size_t maxWorkers = std::max<size_t>(total / kMinRecordedPerWorker, 1);
+            const size_t n = std::min({ static_cast<size_t>(std::max(workers, 1)), maxWorkers, m_recordJobs.size() });
+            if (n == 1) {
+                for (size_t j = 0; j < m_recordJobs.size(); ++j) expandRecorded(j);
+            }
+            else {
+                if (!m_recordWorkers) m_recordWorkers = std::make_unique<RecordWorkers>();
+                RecordWorkers& w = *m_recordWorkers;
+                w.reserve(n - 1);
+                {
+                    std::lock_guard<std::mutex> lk(w.m);
+                    w.batch = this;
+                    w.next = 0;
+                    w.jobs = m_recordJobs.size();
+                    w.active = n;
+                    w.pending = n - 1;
+                    ++w.generation;
+                }
+                w.wake.notify_all();
+                w.claim(*this);
+                std::unique_lock<std::mutex> lk(w.m);
+                w.done.wait(lk, [&w] { return w.pending == 0; });
+            }
+            m_spriteCount += static_cast<int>(total);
+            return;
+        }
+    }
+
+    // One recorder after another, in runs of one sample mode
+    const int mode = m_mode;
+    for (const SpriteRecorder& r : recorders) {
+        const std::span<const Sprite> s = r.sprites();
+        const std::span<const std::uint8_t> modes = r.modes();
+        for (size_t i = 0; i < s.size();) {
+            size_t end = i + 1;
+            while (end < s.size() && modes[end] == modes[i]) ++end;
+            m_mode = modes[i];
+            pushMany(s.subspan(i, end - i));
+            i = end;
+        }
+    }
+    m_mode = mode;
+}
+
+bool SpriteBatch::claimRecorded(std::span<const SpriteRecorder> recorders) {
+    // Entries past the counts are ignored, so a failed claim only has to restore them
+    const int slots = m_slotCount, shapes = m_shapeCount;
+    auto fail = [&] {
+        m_slotCount = slots;
+        m_shapeCount = shapes;
+        return false;
+    };
+    for (const SpriteRecorder& r : recorders) {
+        if (!r.tracked()) return fail();
+        for (GLuint tex : r.textures()) {
+            if (!tex) tex = m_tex;
+            if (findSlot(tex) >= 0) continue;
+            if (m_slotCount == m_maxSlots) return fail();
+            m_slots[m_slotCount++] = tex;
+        }
+        if (!vertexShapes()) continue;
+        for (std::uint32_t word : r.shapes()) {
+            if (shapeIndex(m_shapes.data(), m_shapeCount, word) < 0) return fail();
+        }
+    }
+    return true;
+}
+
+void SpriteBatch::expandRecorded(size_t job) {
+    // Only reads the tables claimRecorded filled and writes this recorder's own ranges
+    const RecordedJob& j = m_recordJobs[job];
+    const std::span<const Sprite> s = j.rec->sprites();
+    const std::span<const std::uint8_t> modes = j.rec->modes();
+    std::uint32_t* flags = &m_flagScratch[j.first - m_recordBase];
+    const bool shapes = vertexShapes();
+    GLuint lastTex = 0;
+    std::uint32_t slot = 0, lastWord = 0, shape = 0; // non-Quad words are never 0
+    for (size_t i = 0; i < s.size(); ++i) {
+        const GLuint tex = s[i].texture ? s[i].texture : m_tex;
+        if (i == 0 || tex != lastTex) {
+            lastTex = tex;
+            slot = static_cast<std::uint32_t>(findSlot(tex));
+        }
+        std::uint32_t index = 0;
+        if (shapes && s[i].shape != SpriteShape::Quad) {
+            const std::uint32_t word = packSpriteShape(s[i]);
+            if (word != lastWord) {
+                lastWord = word;
+                const GLint* table = m_shapes.data();
+                shape = static_cast<std::uint32_t>(std::find(table + 1, table + m_shapeCount, static_cast<GLint>(word)) - table);
+            }
+            index = shape;
+        }
+        flags[i] = slot | index << 8 | modeBits(modes[i]);
+    }
+    expandAt(s.data(), flags, s.size(), j.first);
+}
+
+void SpriteBatch::expand(const Sprite* s, const std::uint32_t* flags, size_t n) {
+    expandAt(s, flags, n, static_cast<size_t>(m_spriteCount));
+    m_spriteCount += static_cast<int>(n);
+}
+
+void SpriteBatch::expandAt(const Sprite* s, const std::uint32_t* flags, size_t n, size_t at) {
+    switch (m_opt.submit) {
+    case SpriteSubmit::Instanced:
+    case SpriteSubmit::Pulled:
+        m_kernels->instances(s, flags, n, &m_cpuInstances[at]);
+        break;
+    case SpriteSubmit::PackedVertices:
+        m_kernels->packed(s, flags, n, &m_cpuPacked[at * 4]);
+        break;
+    case SpriteSubmit::Vertices:
+    default:
+        m_kernels->vertices(s, flags, n, &m_cpuVerts[at * 4]);
+        break;
+    }
 }
 
 void SpriteBatch::endAndDraw() {
-    if (m_spriteCount == 0) return;
+    submitQueued();
+    // Bindings are left as they are: the next frame binds the same VAO/textures again, which
+    // the state cache turns into no-ops instead of an unbind + rebind per flush
+}
+
+void SpriteBatch::submitQueued() {
+    if (deferred()) drawDeferred();
+    flush();
+}
+
+void SpriteBatch::flush() {
+    if (m_spriteCount == 0) {
+        // A run that stopped on a full table may have left entries without sprites
+        m_slotCount = 0;
+        m_shapeCount = 1;
+        return;
+    }
+
+    // Upload only what we used into the next free ring region
+    size_t offset = 0, bytes = 0;
+    if (recordPerSprite()) {
+        bytes = static_cast<size_t>(m_spriteCount) * sizeof(Instance);
+        offset = m_stream.write(m_cpuInstances.data(), bytes, sizeof(Instance));
+    }
+    else {
+        const size_t vsize = vertexSize();
+        const void* src = (m_opt.submit == SpriteSubmit::PackedVertices)
+            ? static_cast<const void*>(m_cpuPacked.data()) : static_cast<const void*>(m_cpuVerts.data());
+        bytes = static_cast<size_t>(m_spriteCount) * 4 * vsize;
+        offset = m_stream.write(src, bytes, 4 * vsize);
+    }
+    frameStats().uploadBytes += bytes;
+
+    m_last.offset = offset;
+    m_last.count = m_spriteCount;
+    m_last.slots = m_slots;
+    m_last.slotCount = m_slotCount;
+    m_last.shapes = m_shapes;
+    m_last.shapeCount = m_shapeCount;
+    m_prog.use(); // another renderer may have drawn since; a no-op through the cache otherwise
+    drawStreamed(m_last);
+    m_stream.fence();
+    m_spriteCount = 0;
+    m_slotCount = 0;
+    m_shapeCount = 1;
+}
+
+bool SpriteBatch::redrawLast() {
+    if (m_last.count == 0) return false;
+    drawStreamed(m_last);
+    m_stream.refence(); // the region is read again, keep it from being overwritten
+    return true;
+}
 
-    // Upload only what we used this frame
-    const GLsizeiptr bytes = static_cast<GLsizeiptr>(m_spriteCount * 4 * sizeof(Vertex));
-    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, m_cpuVerts.data()); // dynamic update
+void SpriteBatch::bindRecords(GLuint tex) {
+    // The unit after the sprite textures (the combined unit count is well above 16)
+    device().activeTexture(GL_TEXTURE0 + m_maxSlots);
+    device().bindTexture(GL_TEXTURE_BUFFER, tex);
+    device().activeTexture(GL_TEXTURE0);
+}
 
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, m_tex);
+void SpriteBatch::drawStreamed(const StreamedDraw& d) {
+    for (int i = 0; i < d.slotCount; ++i) {
+        device().activeTexture(GL_TEXTURE0 + i);
+        device().bindTexture(GL_TEXTURE_2D, d.slots[i]);
+    }
+    device().activeTexture(GL_TEXTURE0);
+    device().bindVertexArray(m_vao);
+    uploadShapes(d.shapes.data(), d.shapeCount);
 
-    glBindVertexArray(m_vao);
-    glDrawElements(GL_TRIANGLES, m_spriteCount * 6, GL_UNSIGNED_INT, (void*)0);
+    FrameStats& fs = frameStats();
+    fs.textureBinds += static_cast<unsigned long long>(d.slotCount);
+    fs.sprites += static_cast<unsigned long long>(d.count);
+    fs.vertices += static_cast<unsigned long long>(d.count) * 4;
+    switch (m_opt.submit) {
+    case SpriteSubmit::Instanced:
+        // One record per sprite; the shader builds the quad from gl_VertexID (triangle strip)
+        pointInstanceAttribs(d.offset);
+        device().drawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, d.count);
+        ++fs.drawCalls;
+        break;
+    case SpriteSubmit::Pulled:
+        // gl_VertexID includes the base vertex, so gl_VertexID / 4 indexes the whole ring
+        bindRecords(m_recordTex);
+        drawQuads(indexType(), static_cast<GLint>(d.offset / sizeof(Instance) * 4), d.count);
+        break;
+    default:
+        // Indices are relative, so the region start becomes the base vertex
+        drawQuads(indexType(), static_cast<GLint>(d.offset / vertexSize()), d.count);
+        break;
+    }
+}
+
+bool SpriteBatch::buildStatic(StaticSpriteBatch& out, std::span<const Sprite> sprites) {
+    if (!m_kernels) return false; // batch not initialized
+    const size_t n = sprites.size();
+    out.m_runs.clear();
+    out.m_spriteCount = static_cast<int>(n);
+    out.m_dirty = false;
+    if (n == 0) return true;
+
+    // Split into runs whose textures fit in the units and shapes in one table; flags hold
+    // run-local slots and shape indices
+    std::vector<std::uint32_t> flags(n);
+    const std::uint32_t mode = modeBits(m_mode);
+    const bool shapes = vertexShapes();
+    StaticSpriteBatch::Run run;
+    for (size_t i = 0; i < n; ++i) {
+        const GLuint tex = sprites[i].texture ? sprites[i].texture : m_tex;
+        const std::uint32_t word = shapes ? packSpriteShape(sprites[i]) : 0u;
+        int slot = -1;
+        for (int k = 0; k < run.slotCount; ++k) {
+            if (run.slots[k] == tex) { slot = k; break; }
+        }
+        int shape = (slot < 0 && run.slotCount == m_maxSlots) ? -1 : shapeIndex(run.shapes.data(), run.shapeCount, word);
+        if (shape < 0) {
+            out.m_runs.push_back(run);
+            run = {};
+            run.first = static_cast<int>(i);
+            slot = -1;
+            shape = shapeIndex(run.shapes.data(), run.shapeCount, word);
+        }
+        if (slot < 0) {
+            slot = run.slotCount;
+            run.slots[run.slotCount++] = tex;
+        }
+        flags[i] = static_cast<std::uint32_t>(slot) | static_cast<std::uint32_t>(shape) << 8 | mode;
+        ++run.count;
+    }
+    out.m_runs.push_back(run);
+
+    // Same kernels and layout as the streaming path, uploaded once
+    if (!out.m_vao) {
+        device().genVertexArrays(1, &out.m_vao);
+        device().genBuffers(1, &out.m_vbo);
+    }
+    out.m_submit = m_opt.submit;
+    FrameStats& fs = frameStats();
+    device().bindVertexArray(out.m_vao);
+    device().bindBuffer(GL_ARRAY_BUFFER, out.m_vbo);
+    switch (m_opt.submit) {
+    case SpriteSubmit::Instanced:
+    case SpriteSubmit::Pulled: {
+        std::vector<Instance> data(n);
+        m_kernels->instances(sprites.data(), flags.data(), n, data.data());
+        device().bufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(n * sizeof(Instance)), data.data(), GL_STATIC_DRAW);
+        fs.uploadBytes += n * sizeof(Instance);
+        if (m_opt.submit == SpriteSubmit::Instanced) {
+            pointInstanceAttribs(0);
+        }
+        else {
+            if (!out.m_recordTex) device().genTextures(1, &out.m_recordTex);
+            device().bindTexture(GL_TEXTURE_BUFFER, out.m_recordTex);
+            device().texBuffer(GL_TEXTURE_BUFFER, GL_RGBA32UI, out.m_vbo);
+            device().bindTexture(GL_TEXTURE_BUFFER, 0);
+        }
+        break;
+    }
+    case SpriteSubmit::PackedVertices: {
+        std::vector<PackedVertex> data(n * 4);
+        m_kernels->packed(sprites.data(), flags.data(), n, data.data());
+        device().bufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(data.size() * sizeof(PackedVertex)), data.data(), GL_STATIC_DRAW);
+        fs.uploadBytes += data.size() * sizeof(PackedVertex);
+        break;
+    }
+    case SpriteSubmit::Vertices:
+    default: {
+        std::vector<Vertex> data(n * 4);
+        m_kernels->vertices(sprites.data(), flags.data(), n, data.data());
+        device().bufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(data.size() * sizeof(Vertex)), data.data(), GL_STATIC_DRAW);
+        fs.uploadBytes += data.size() * sizeof(Vertex);
+        break;
+    }
+    }
 
-    // cleanup bindings (optional)
-    glBindVertexArray(0);
-    glBindTexture(GL_TEXTURE_2D, 0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    if (m_opt.submit != SpriteSubmit::Instanced) {
+        if (!out.m_ebo) device().genBuffers(1, &out.m_ebo);
+        device().bindBuffer(GL_ELEMENT_ARRAY_BUFFER, out.m_ebo);
+        out.m_indexType = indexType();
+        fs.uploadBytes += uploadQuadIndices(out.m_indexType, n);
+        if (m_opt.submit != SpriteSubmit::Pulled) setupVertexLayout(out.m_vbo);
+    }
+
+    device().bindVertexArray(0);
+    device().bindBuffer(GL_ARRAY_BUFFER, 0);
+    return true;
+}
+
+void SpriteBatch::drawStatic(const StaticSpriteBatch& sb) {
+    if (sb.m_runs.empty() || !sb.m_vao) return;
+    // Instanced and Pulled data need their own shader variant; the two vertex formats share one
+    auto variant = [](SpriteSubmit s) { return (s == SpriteSubmit::PackedVertices) ? SpriteSubmit::Vertices : s; };
+    assert(variant(sb.m_submit) == variant(m_opt.submit));
+    if (variant(sb.m_submit) != variant(m_opt.submit)) return;
+
+    // Keep submission order: whatever is queued draws underneath
+    submitQueued();
+    m_prog.use();
+
+    FrameStats& fs = frameStats();
+    device().bindVertexArray(sb.m_vao);
+    for (const StaticSpriteBatch::Run& run : sb.m_runs) {
+        fs.textureBinds += static_cast<unsigned long long>(run.slotCount);
+        fs.sprites += static_cast<unsigned long long>(run.count);
+        fs.vertices += static_cast<unsigned long long>(run.count) * 4;
+        for (int i = 0; i < run.slotCount; ++i) {
+            device().activeTexture(GL_TEXTURE0 + i);
+            device().bindTexture(GL_TEXTURE_2D, run.slots[i]);
+        }
+        device().activeTexture(GL_TEXTURE0);
+        uploadShapes(run.shapes.data(), run.shapeCount);
+        if (sb.m_submit == SpriteSubmit::Instanced) {
+            device().bindBuffer(GL_ARRAY_BUFFER, sb.m_vbo);
+            pointInstanceAttribs(static_cast<size_t>(run.first) * sizeof(Instance));
+            device().drawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, run.count);
+            ++fs.drawCalls;
+        }
+        else {
+            if (sb.m_submit == SpriteSubmit::Pulled) bindRecords(sb.m_recordTex);
+            drawQuads(sb.m_indexType, run.first * 4, run.count);
+        }
+    }
+    device().bindVertexArray(0);
+}
+
+void SpriteBatch::drawDeferred() {
+    const size_t n = m_deferred.size();
+    m_sortKeys.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        const DeferredSprite& d = m_deferred[i];
+        std::uint64_t key = std::uint64_t(static_cast<std::uint16_t>(d.sprite.layer + 0x8000)) << 48;
+        if (m_opt.sort == SpriteSort::ByKey) {
+            key |= std::uint64_t(d.sprite.texture & 0xFFFFF) << 24;
+            key |= std::uint64_t(sortableFloat(d.sprite.depth) >> 8);
+        }
+        m_sortKeys[i] = { key, static_cast<std::uint32_t>(i) };
+    }
+    if (m_opt.sort != SpriteSort::None) radixSort(m_sortKeys, m_sortScratch);
+
+    if (m_opt.opaquePass) {
+        drawDepthPasses();
+        m_deferred.clear();
+        return;
+    }
+
+    // Walk in key order; a draw is only split when texture slots run out
+    for (const SortEntry& e : m_sortKeys) {
+        const DeferredSprite& d = m_deferred[e.index];
+        emit(d.sprite, d.mode);
+    }
+    m_deferred.clear();
+}
+
+// Depth of the sprite at back-to-front position i, in flags bits 14-31 (0 = no depth).
+// sprite_batch.vert maps it to z = 1 - bits * 2^-18: exact in float and distinct in a 24-bit
+// depth buffer, later sprites nearer. Past 2^18 - 1 sprites the front ones share a depth.
+static std::uint32_t depthBits(size_t i) {
+    constexpr size_t kMaxRank = (size_t(1) << 18) - 1;
+    return static_cast<std::uint32_t>(std::min(i + 1, kMaxRank)) << 14;
+}
+
+void SpriteBatch::drawDepthPasses() {
+    flush(); // what is already queued draws underneath, without depth
+
+    m_opaqueOrder.clear();
+    for (size_t i = 0; i < m_sortKeys.size(); ++i) {
+        const DeferredSprite& d = m_deferred[m_sortKeys[i].index];
+        if (d.mode == 0 && d.sprite.color.a >= 1.0f && d.sprite.shape == SpriteShape::Quad &&
+            m_opaqueTextures.count(d.sprite.texture))
+            m_opaqueOrder.push_back(static_cast<std::uint32_t>(i));
+    }
+
+    // Nothing opaque: plain blended back-to-front, the depth buffer is not touched
+    const bool depth = !m_opaqueOrder.empty();
+    bool blendWasOn = false, depthTestWasOn = false;
+    if (depth) {
+        // Restored on the way out; the cache answers without a GL round trip once it has seen them
+        blendWasOn = device().isEnabled(GL_BLEND) == GL_TRUE;
+        depthTestWasOn = device().isEnabled(GL_DEPTH_TEST) == GL_TRUE;
+
+        device().depthMask(GL_TRUE);
+        device().clear(GL_DEPTH_BUFFER_BIT);
+        device().enable(GL_DEPTH_TEST);
+        device().depthFunc(GL_LESS);
+
+        // Opaque, front-to-back: later (nearer) sprites fill the depth buffer first, so
+        // whatever they cover fails the depth test instead of being shaded and blended
+        device().disable(GL_BLEND);
+        for (size_t k = m_opaqueOrder.size(); k-- > 0;) {
+            const size_t i = m_opaqueOrder[k];
+            emit(m_deferred[m_sortKeys[i].index].sprite, 0, depthBits(i));
+        }
+        flush();
+        if (blendWasOn) device().enable(GL_BLEND);
+
+        // Translucent: tested against the opaque depth, not written
+        device().depthMask(GL_FALSE);
+    }
+
+    size_t next = 0; // next opaque position (already drawn)
+    for (size_t i = 0; i < m_sortKeys.size(); ++i) {
+        if (next < m_opaqueOrder.size() && m_opaqueOrder[next] == i) {
+            ++next;
+            continue;
+        }
+        const DeferredSprite& d = m_deferred[m_sortKeys[i].index];
+        emit(d.sprite, d.mode, depth ? depthBits(i) : 0u);
+    }
+    flush();
+
+    if (depth) {
+        device().depthMask(GL_TRUE);
+        if (!depthTestWasOn) device().disable(GL_DEPTH_TEST);
+    }
+}
+
+void SpriteBatch::bindSamplerUnits() {
+    // uTex[i] samples texture unit i, sprite records (Pulled) the unit after them
+    if (m_uRecords != -1) device().uniform1i(m_uRecords, m_maxSlots);
+    if (m_uTex == -1) return;
+    GLint units[kMaxTextureSlots];
+    for (int i = 0; i < kMaxTextureSlots; ++i) units[i] = i;
+    device().uniform1iv(m_uTex, m_maxSlots, units);
 }
 
 void SpriteBatch::setTexture(GLuint tex) {
@@ -186,14 +1118,21 @@ void SpriteBatch::setTexture(GLuint tex) {
 void SpriteBatch::beginWithVP(const glm::mat4& VP) 
 {
     m_spriteCount = 0;
+    m_slotCount = 0;
+    m_shapeCount = 1;
+    m_deferred.clear();
     m_prog.use();
-    if (m_uP != -1) glUniformMatrix4fv(m_uP, 1, GL_FALSE, glm::value_ptr(VP));
-    if (m_uTex != -1) glUniform1i(m_uTex, 0);
-    if (m_uMode != -1) glUniform1i(m_uMode, 0); // default: normal RGBA
+    frameData().setView(VP);
+    bindSamplerUnits();
+    m_mode = 0; // default: normal RGBA
 }
 
  void SpriteBatch::setSampleMode(int mode) 
  {
-    m_prog.use();
-    if (m_uMode != -1) glUniform1i(m_uMode, mode);
+    m_mode = mode; // no flush: the mode travels in each sprite's flags
+}
+
+void SpriteBatch::setTextureOpaque(GLuint tex, bool opaque) {
+    if (opaque) m_opaqueTextures.insert(tex);
+    else m_opaqueTextures.erase(tex);
 }
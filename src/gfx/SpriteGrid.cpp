@@ -0,0 +1,149 @@
+#include "gfx/SpriteGrid.hpp"
+#include <algorithm>
+#include <cmath>
+#include "gfx/SpriteBatch.hpp"
+
+Rect2D SpriteGrid::bounds(const Sprite& s) {
+    if (s.rotation == 0.0f) return { s.pos, s.pos + s.size };
+
+    // Rotated: box around the four corners turned about the pivot
+    const float c = std::cos(s.rotation), sn = std::sin(s.rotation);
+    const glm::vec2 pv = s.pivot * s.size;
+    const glm::vec2 origin = s.pos + pv;
+    Rect2D r{ origin, origin };
+    for (int k = 0; k < 4; ++k) {
+        const glm::vec2 local = glm::vec2((k & 1) ? s.size.x : 0.0f, (k & 2) ? s.size.y : 0.0f) - pv;
+        const glm::vec2 p = origin + glm::vec2(c * local.x - sn * local.y, sn * local.x + c * local.y);
+        r.min = glm::min(r.min, p);
+        r.max = glm::max(r.max, p);
+    }
+    return r;
+}
+
+SpriteGrid::CellRange SpriteGrid::cellRange(const Rect2D& r) const {
+    return {
+        static_cast<int>(std::floor(r.min.x * m_invCell)), static_cast<int>(std::floor(r.min.y * m_invCell)),
+        static_cast<int>(std::floor(r.max.x * m_invCell)), static_cast<int>(std::floor(r.max.y * m_invCell))
+    };
+}
+
+void SpriteGrid::clear() {
+    m_items.clear();
+    m_cells.clear();
+    m_large.clear();
+    m_stamp.clear();
+    m_live = 0;
+}
+
+SpriteGrid::Id SpriteGrid::insert(const Sprite& s) {
+    const Id id = static_cast<Id>(m_items.size());
+    m_items.push_back({});
+    m_stamp.push_back(0);
+    Item& it = m_items.back();
+    it.sprite = s;
+    it.live = true;
+    ++m_live;
+    link(id);
+    return id;
+}
+
+void SpriteGrid::update(Id id, const Sprite& s) {
+    Item& it = m_items[id];
+    if (!it.live) return;
+    const Rect2D b = bounds(s);
+    const CellRange cr = cellRange(b);
+    // Common case: moved within the same cells, only the payload changes
+    if (!it.large && cr.x0 == it.cells.x0 && cr.y0 == it.cells.y0 && cr.x1 == it.cells.x1 && cr.y1 == it.cells.y1) {
+        it.sprite = s;
+        it.bounds = b;
+        return;
+    }
+    unlink(id);
+    it.sprite = s;
+    link(id);
+}
+
+void SpriteGrid::remove(Id id) {
+    Item& it = m_items[id];
+    if (!it.live) return;
+    unlink(id);
+    it.live = false;
+    --m_live;
+}
+
+void SpriteGrid::link(Id id) {
+    Item& it = m_items[id];
+    it.bounds = bounds(it.sprite);
+    it.cells = cellRange(it.bounds);
+    const long long cells = (long long)(it.cells.x1 - it.cells.x0 + 1) * (it.cells.y1 - it.cells.y0 + 1);
+    it.large = cells > kMaxCellsPerSprite;
+    if (it.large) {
+        m_large.push_back(id);
+        return;
+    }
+    for (int y = it.cells.y0; y <= it.cells.y1; ++y)
+        for (int x = it.cells.x0; x <= it.cells.x1; ++x)
+            m_cells[key(x, y)].push_back(id);
+}
+
+void SpriteGrid::unlink(Id id) {
+    const Item& it = m_items[id];
+    auto erase = [id](std::vector<Id>& v) { v.erase(std::find(v.begin(), v.end(), id)); };
+    if (it.large) {
+        erase(m_large);
+        return;
+    }
+    for (int y = it.cells.y0; y <= it.cells.y1; ++y) {
+        for (int x = it.cells.x0; x <= it.cells.x1; ++x) {
+            auto c = m_cells.find(key(x, y));
+            erase(c->second);
+            if (c->second.empty()) m_cells.erase(c);
+        }
+    }
+}
+
+void SpriteGrid::query(const Rect2D& r, std::vector<Sprite>& out) const {
+    if (++m_query == 0) { // stamp wrapped: forget every old mark
+        std::fill(m_stamp.begin(), m_stamp.end(), 0u);
+        m_query = 1;
+    }
+    m_hits.clear();
+    auto visit = [&](const std::vector<Id>& ids) {
+        for (Id id : ids) {
+            if (m_stamp[id] == m_query) continue; // already seen through another cell
+            m_stamp[id] = m_query;
+            if (m_items[id].bounds.overlaps(r)) m_hits.push_back(id);
+        }
+    };
+
+    // Zoomed far out the rect can span more cells than exist: walk the occupied ones instead
+    const CellRange cr = cellRange(r);
+    const long long span = (long long)(cr.x1 - cr.x0 + 1) * (cr.y1 - cr.y0 + 1);
+    if (span > static_cast<long long>(m_cells.size())) {
+        for (const auto& [k, ids] : m_cells) {
+            const int cx = static_cast<int>(std::int32_t(k >> 32)), cy = static_cast<int>(std::int32_t(k & 0xFFFFFFFFu));
+            if (cx >= cr.x0 && cx <= cr.x1 && cy >= cr.y0 && cy <= cr.y1) visit(ids);
+        }
+    }
+    else {
+        for (int y = cr.y0; y <= cr.y1; ++y) {
+            for (int x = cr.x0; x <= cr.x1; ++x) {
+                auto c = m_cells.find(key(x, y));
+                if (c != m_cells.end()) visit(c->second);
+            }
+        }
+    }
+    visit(m_large);
+
+    // Registration order == id order
+    std::sort(m_hits.begin(), m_hits.end());
+    out.reserve(out.size() + m_hits.size());
+    for (Id id : m_hits) out.push_back(m_items[id].sprite);
+}
+
+size_t SpriteGrid::draw(SpriteBatch& batch, const OrthoCamera2D& cam) const {
+    m_visible.clear();
+    query(cam.visibleRect(), m_visible);
+    batch.pushMany(m_visible);
+    return m_visible.size();
+}
@@ -0,0 +1,394 @@
+#include "gfx/SpriteKernels.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <glm/glm.hpp>   // packUnorm4x8, packHalf2x16, packUnorm2x16
+
+#if GFX_SIMD_X86
+#include <immintrin.h>
+#endif
+
+// The SIMD kernels load pos+size and uv/color as 4 contiguous floats
+static_assert(offsetof(Sprite, size) == offsetof(Sprite, pos) + 8, "Sprite::pos/size must be contiguous");
+static_assert(offsetof(Sprite, color) == offsetof(Sprite, uv) + 16, "Sprite::uv/color must be contiguous");
+static_assert(sizeof(SpriteVertex) == 36, "vertex is 9 dwords");
+static_assert(sizeof(SpritePackedVertex) == 16, "packed vertex is 4 dwords");
+static_assert(sizeof(SpriteInstance) == 48, "instance is 3 RGBA32UI texels");
+
+// Rotations are gathered and their sin/cos computed this many sprites at a time
+static constexpr size_t kBlock = 64;
+
+// ---------------------------------------------------------------- scalar
+
+// Corners BL, BR, TL, TR of a rotated sprite
+static inline void rotatedCorners(const Sprite& sp, float c, float s, glm::vec2 out[4]) {
+    const glm::vec2 pv = sp.pivot * sp.size;
+    const glm::vec2 origin = sp.pos + pv;
+    const glm::vec2 local[4] = {
+        -pv, { sp.size.x - pv.x, -pv.y }, { -pv.x, sp.size.y - pv.y }, sp.size - pv
+    };
+    for (int k = 0; k < 4; ++k) {
+        out[k] = origin + glm::vec2(c * local[k].x - s * local[k].y, s * local[k].x + c * local[k].y);
+    }
+}
+
+static inline void cornersScalar(const Sprite& sp, glm::vec2 out[4]) {
+    if (sp.rotation != 0.0f) {
+        rotatedCorners(sp, std::cos(sp.rotation), std::sin(sp.rotation), out);
+        return;
+    }
+    const glm::vec2 p0 = sp.pos, p1 = sp.pos + sp.size;
+    out[0] = p0;
+    out[1] = { p1.x, p0.y };
+    out[2] = { p0.x, p1.y };
+    out[3] = p1;
+}
+
+static void verticesScalar(const Sprite* s, const std::uint32_t* flags, size_t n, SpriteVertex* out) {
+    for (size_t i = 0; i < n; ++i, out += 4) {
+        const Sprite& sp = s[i];
+        glm::vec2 p[4];
+        cornersScalar(sp, p);
+        const float u0 = sp.uv.x, v0 = sp.uv.y, u1 = sp.uv.z, v1 = sp.uv.w;
+        const float r = sp.color.r, g = sp.color.g, b = sp.color.b, a = sp.color.a;
+        const std::uint32_t f = flags[i];
+
+        // bottom-left
+        out[0] = { p[0].x, p[0].y, u0, v0, r, g, b, a, f };
+        // bottom-right
+        out[1] = { p[1].x, p[1].y, u1, v0, r, g, b, a, f };
+        // top-left
+        out[2] = { p[2].x, p[2].y, u0, v1, r, g, b, a, f };
+        // top-right
+        out[3] = { p[3].x, p[3].y, u1, v1, r, g, b, a, f };
+    }
+}
+
+static void packedScalar(const Sprite* s, const std::uint32_t* flags, size_t n, SpritePackedVertex* out) {
+    for (size_t i = 0; i < n; ++i, out += 4) {
+        const Sprite& sp = s[i];
+        glm::vec2 p[4];
+        cornersScalar(sp, p);
+        const std::uint32_t rgba = glm::packUnorm4x8(sp.color);
+        const std::uint32_t f = flags[i];
+        out[0] = { glm::packHalf2x16(p[0]), glm::packUnorm2x16({ sp.uv.x, sp.uv.y }), rgba, f };
+        out[1] = { glm::packHalf2x16(p[1]), glm::packUnorm2x16({ sp.uv.z, sp.uv.y }), rgba, f };
+        out[2] = { glm::packHalf2x16(p[2]), glm::packUnorm2x16({ sp.uv.x, sp.uv.w }), rgba, f };
+        out[3] = { glm::packHalf2x16(p[3]), glm::packUnorm2x16({ sp.uv.z, sp.uv.w }), rgba, f };
+    }
+}
+
+static void instancesScalar(const Sprite* s, const std::uint32_t* flags, size_t n, SpriteInstance* out) {
+    for (size_t i = 0; i < n; ++i) {
+        const Sprite& sp = s[i];
+        out[i] = { sp.pos.x, sp.pos.y, sp.size.x, sp.size.y,
+            glm::packUnorm2x16({ sp.uv.x, sp.uv.y }), glm::packUnorm2x16({ sp.uv.z, sp.uv.w }),
+            glm::packUnorm4x8(sp.color), flags[i], sp.rotation, glm::packUnorm2x16(sp.pivot),
+            packSpriteShape(sp), 0u };
+    }
+}
+
+// ---------------------------------------------------------------- points (all tiers)
+
+// Streaming loads from separate arrays: the compiler vectorizes these as they are
+static void pointVerticesScalar(const SpritePoints& p, size_t first, size_t n, const Sprite& tmpl,
+    const std::uint32_t* flags, SpriteVertex* out) {
+    const float u0 = tmpl.uv.x, v0 = tmpl.uv.y, u1 = tmpl.uv.z, v1 = tmpl.uv.w;
+    for (size_t i = first; i < first + n; ++i, out += 4) {
+        const float half = 0.5f * p.size[i];
+        const float x0 = p.x[i] - half, y0 = p.y[i] - half, x1 = p.x[i] + half, y1 = p.y[i] + half;
+        const float r = p.r[i], g = p.g[i], b = p.b[i], a = p.a[i];
+        const std::uint32_t f = *flags++;
+        out[0] = { x0, y0, u0, v0, r, g, b, a, f };
+        out[1] = { x1, y0, u1, v0, r, g, b, a, f };
+        out[2] = { x0, y1, u0, v1, r, g, b, a, f };
+        out[3] = { x1, y1, u1, v1, r, g, b, a, f };
+    }
+}
+
+static void pointPackedScalar(const SpritePoints& p, size_t first, size_t n, const Sprite& tmpl,
+    const std::uint32_t* flags, SpritePackedVertex* out) {
+    const std::uint32_t uv00 = glm::packUnorm2x16({ tmpl.uv.x, tmpl.uv.y }), uv10 = glm::packUnorm2x16({ tmpl.uv.z, tmpl.uv.y });
+    const std::uint32_t uv01 = glm::packUnorm2x16({ tmpl.uv.x, tmpl.uv.w }), uv11 = glm::packUnorm2x16({ tmpl.uv.z, tmpl.uv.w });
+    for (size_t i = first; i < first + n; ++i, out += 4) {
+        const float half = 0.5f * p.size[i];
+        const float x0 = p.x[i] - half, y0 = p.y[i] - half, x1 = p.x[i] + half, y1 = p.y[i] + half;
+        const std::uint32_t rgba = glm::packUnorm4x8({ p.r[i], p.g[i], p.b[i], p.a[i] });
+        const std::uint32_t f = *flags++;
+        out[0] = { glm::packHalf2x16({ x0, y0 }), uv00, rgba, f };
+        out[1] = { glm::packHalf2x16({ x1, y0 }), uv10, rgba, f };
+        out[2] = { glm::packHalf2x16({ x0, y1 }), uv01, rgba, f };
+        out[3] = { glm::packHalf2x16({ x1, y1 }), uv11, rgba, f };
+    }
+}
+
+static void pointInstancesScalar(const SpritePoints& p, size_t first, size_t n, const Sprite& tmpl,
+    const std::uint32_t* flags, SpriteInstance* out) {
+    const std::uint32_t uv0 = glm::packUnorm2x16({ tmpl.uv.x, tmpl.uv.y }), uv1 = glm::packUnorm2x16({ tmpl.uv.z, tmpl.uv.w });
+    for (size_t i = first; i < first + n; ++i, ++out) {
+        const float size = p.size[i];
+        *out = { p.x[i] - 0.5f * size, p.y[i] - 0.5f * size, size, size, uv0, uv1,
+            glm::packUnorm4x8({ p.r[i], p.g[i], p.b[i], p.a[i] }), *flags++, 0.0f, 0u,
+            packSpriteShape(tmpl, { size, size }), 0u };
+    }
+}
+
+#if GFX_SIMD_X86
+// ---------------------------------------------------------------- SSE2
+
+// Same rounding as glm::packUnorm4x8 (round-to-nearest via cvtps)
+GFX_TARGET_SSE2 static inline std::uint32_t packColorSSE2(__m128 c) {
+    c = _mm_min_ps(_mm_max_ps(c, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+    __m128i v = _mm_cvtps_epi32(_mm_mul_ps(c, _mm_set1_ps(255.0f)));
+    v = _mm_packs_epi32(v, v);
+    v = _mm_packus_epi16(v, v);
+    return static_cast<std::uint32_t>(_mm_cvtsi128_si32(v));
+}
+
+GFX_TARGET_SSE2 static inline __m128 selectSSE2(__m128 mask, __m128 a, __m128 b) {
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); // mask ? a : b
+}
+
+// sin/cos of 4 angles: Cody-Waite reduction to [-pi/4, pi/4] plus minimax polynomials
+// (Cephes sinf/cosf). ~1e-7 abs error for |x| up to a few thousand radians.
+GFX_TARGET_SSE2 static inline void sincosSSE2(__m128 x, __m128& outSin, __m128& outCos) {
+    const __m128i q = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(0.63661977236758134f))); // x * 2/pi
+    const __m128 qf = _mm_cvtepi32_ps(q);
+    __m128 y = _mm_sub_ps(x, _mm_mul_ps(qf, _mm_set1_ps(1.5703125f)));
+    y = _mm_sub_ps(y, _mm_mul_ps(qf, _mm_set1_ps(4.837512969970703125e-4f)));
+    y = _mm_sub_ps(y, _mm_mul_ps(qf, _mm_set1_ps(7.54978995489188216e-8f)));
+    const __m128 z = _mm_mul_ps(y, y);
+
+    __m128 sp = _mm_set1_ps(-1.9515295891e-4f);
+    sp = _mm_add_ps(_mm_mul_ps(sp, z), _mm_set1_ps(8.3321608736e-3f));
+    sp = _mm_add_ps(_mm_mul_ps(sp, z), _mm_set1_ps(-1.6666654611e-1f));
+    sp = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(sp, z), y), y);
+
+    __m128 cp = _mm_set1_ps(2.443315711809948e-5f);
+    cp = _mm_add_ps(_mm_mul_ps(cp, z), _mm_set1_ps(-1.388731625493765e-3f));
+    cp = _mm_add_ps(_mm_mul_ps(cp, z), _mm_set1_ps(4.166664568298827e-2f));
+    cp = _mm_mul_ps(_mm_mul_ps(cp, z), z);
+    cp = _mm_add_ps(_mm_sub_ps(cp, _mm_mul_ps(z, _mm_set1_ps(0.5f))), _mm_set1_ps(1.0f));
+
+    // Quadrant: odd swaps sin/cos, bit 1 negates sin, bit 1 of (q + 1) negates cos
+    const __m128i one = _mm_set1_epi32(1), two = _mm_set1_epi32(2);
+    const __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(q, one), one));
+    const __m128 sinSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(q, two), 30));
+    const __m128 cosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(q, one), two), 30));
+    outSin = _mm_xor_ps(selectSSE2(swap, cp, sp), sinSign);
+    outCos = _mm_xor_ps(selectSSE2(swap, sp, cp), cosSign);
+}
+
+// Gathers the block's rotations; returns false (and skips the trig) if none is rotated
+GFX_TARGET_SSE2 static bool blockSinCos(const Sprite* s, size_t m, float* sn, float* cs) {
+    alignas(16) float rot[kBlock + 3] = {};
+    bool any = false;
+    for (size_t i = 0; i < m; ++i) {
+        rot[i] = s[i].rotation;
+        any |= (rot[i] != 0.0f);
+    }
+    if (!any) return false;
+    for (size_t i = 0; i < m; i += 4) {
+        __m128 vs, vc;
+        sincosSSE2(_mm_load_ps(rot + i), vs, vc);
+        _mm_store_ps(sn + i, vs);
+        _mm_store_ps(cs + i, vc);
+    }
+    return true;
+}
+
+// Corners of a rotated sprite, all four transformed at once:
+// xy01 = (x0 y0 x1 y1), xy23 = (x2 y2 x3 y3) for BL, BR, TL, TR
+GFX_TARGET_SSE2 static inline void rotatedCornersSSE2(const Sprite& sp, float c, float s, __m128& xy01, __m128& xy23) {
+    const float w = sp.size.x, h = sp.size.y;
+    const float px = sp.pivot.x * w, py = sp.pivot.y * h;
+    const __m128 lx = _mm_sub_ps(_mm_set_ps(w, 0.0f, w, 0.0f), _mm_set1_ps(px)); // 0 w 0 w
+    const __m128 ly = _mm_sub_ps(_mm_set_ps(h, h, 0.0f, 0.0f), _mm_set1_ps(py)); // 0 0 h h
+    const __m128 vc = _mm_set1_ps(c), vs = _mm_set1_ps(s);
+    const __m128 rx = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(vc, lx), _mm_mul_ps(vs, ly)), _mm_set1_ps(sp.pos.x + px));
+    const __m128 ry = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vs, lx), _mm_mul_ps(vc, ly)), _mm_set1_ps(sp.pos.y + py));
+    xy01 = _mm_unpacklo_ps(rx, ry);
+    xy23 = _mm_unpackhi_ps(rx, ry);
+}
+
+GFX_TARGET_SSE2 static inline void quadSSE2(const Sprite& sp, std::uint32_t f, SpriteVertex* out) {
+    const __m128 ps = _mm_loadu_ps(&sp.pos.x);                              // x  y  w  h
+    const __m128 q = _mm_add_ps(ps, _mm_movelh_ps(_mm_setzero_ps(), ps));   // x0 y0 x1 y1
+    const __m128 uv = _mm_loadu_ps(&sp.uv.x);                               // u0 v0 u1 v1
+    const __m128 col = _mm_loadu_ps(&sp.color.r);
+
+    _mm_storeu_ps(&out[0].x, _mm_shuffle_ps(q, uv, _MM_SHUFFLE(1, 0, 1, 0))); // x0 y0 u0 v0
+    _mm_storeu_ps(&out[1].x, _mm_shuffle_ps(q, uv, _MM_SHUFFLE(1, 2, 1, 2))); // x1 y0 u1 v0
+    _mm_storeu_ps(&out[2].x, _mm_shuffle_ps(q, uv, _MM_SHUFFLE(3, 0, 3, 0))); // x0 y1 u0 v1
+    _mm_storeu_ps(&out[3].x, _mm_shuffle_ps(q, uv, _MM_SHUFFLE(3, 2, 3, 2))); // x1 y1 u1 v1
+    for (int c = 0; c < 4; ++c) {
+        _mm_storeu_ps(&out[c].r, col);
+        out[c].flags = f;
+    }
+}
+
+GFX_TARGET_SSE2 static inline void rotatedQuadSSE2(const Sprite& sp, std::uint32_t f, float c, float s, SpriteVertex* out) {
+    __m128 xy01, xy23;
+    rotatedCornersSSE2(sp, c, s, xy01, xy23);
+    const __m128 uv = _mm_loadu_ps(&sp.uv.x);
+    const __m128 uvA = _mm_shuffle_ps(uv, uv, _MM_SHUFFLE(1, 2, 1, 0));     // u0 v0 u1 v0
+    const __m128 uvB = _mm_shuffle_ps(uv, uv, _MM_SHUFFLE(3, 2, 3, 0));     // u0 v1 u1 v1
+    const __m128 col = _mm_loadu_ps(&sp.color.r);
+
+    _mm_storeu_ps(&out[0].x, _mm_movelh_ps(xy01, uvA));                      // x0 y0 u0 v0
+    _mm_storeu_ps(&out[1].x, _mm_movehl_ps(uvA, xy01));                      // x1 y1 u1 v0
+    _mm_storeu_ps(&out[2].x, _mm_movelh_ps(xy23, uvB));                      // x2 y2 u0 v1
+    _mm_storeu_ps(&out[3].x, _mm_movehl_ps(uvB, xy23));                      // x3 y3 u1 v1
+    for (int k = 0; k < 4; ++k) {
+        _mm_storeu_ps(&out[k].r, col);
+        out[k].flags = f;
+    }
+}
+
+GFX_TARGET_SSE2 static void verticesSSE2(const Sprite* s, const std::uint32_t* flags, size_t n, SpriteVertex* out) {
+    alignas(16) float sn[kBlock + 3], cs[kBlock + 3];
+    for (size_t base = 0; base < n; base += kBlock) {
+        const size_t m = std::min(kBlock, n - base);
+        const bool rotated = blockSinCos(s + base, m, sn, cs);
+        for (size_t i = 0; i < m; ++i, out += 4) {
+            const Sprite& sp = s[base + i];
+            if (rotated && sp.rotation != 0.0f) rotatedQuadSSE2(sp, flags[base + i], cs[i], sn[i], out);
+            else quadSSE2(sp, flags[base + i], out);
+        }
+    }
+}
+
+GFX_TARGET_SSE2 static void instancesSSE2(const Sprite* s, const std::uint32_t* flags, size_t n, SpriteInstance* out) {
+    for (size_t i = 0; i < n; ++i) {
+        _mm_storeu_ps(&out[i].x, _mm_loadu_ps(&s[i].pos.x));
+        out[i].uv0 = glm::packUnorm2x16({ s[i].uv.x, s[i].uv.y });
+        out[i].uv1 = glm::packUnorm2x16({ s[i].uv.z, s[i].uv.w });
+        out[i].rgba = packColorSSE2(_mm_loadu_ps(&s[i].color.r));
+        out[i].flags = flags[i];
+        out[i].rotation = s[i].rotation;
+        out[i].pivot = glm::packUnorm2x16(s[i].pivot);
+        out[i].shape = packSpriteShape(s[i]);
+        out[i].reserved = 0;
+    }
+}
+
+// ---------------------------------------------------------------- AVX2 (+F16C, SSE4.1)
+
+GFX_TARGET_AVX2 static inline __m256 load2(const float* lo, const float* hi) {
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(lo)), _mm_loadu_ps(hi), 1);
+}
+
+GFX_TARGET_AVX2 static inline void store2(float* lo, float* hi, __m256 v) {
+    _mm_storeu_ps(lo, _mm256_castps256_ps128(v));
+    _mm_storeu_ps(hi, _mm256_extractf128_ps(v, 1));
+}
+
+// Two unrotated sprites at once, one per 128-bit lane (the shuffles are lane-local)
+GFX_TARGET_AVX2 static inline void quadPairAVX2(const Sprite* s, const std::uint32_t* flags, SpriteVertex* out) {
+    const __m256 ps = load2(&s[0].pos.x, &s[1].pos.x);
+    const __m256 q = _mm256_add_ps(ps, _mm256_shuffle_ps(_mm256_setzero_ps(), ps, _MM_SHUFFLE(1, 0, 1, 0)));
+    const __m256 uv = load2(&s[0].uv.x, &s[1].uv.x);
+    const __m256 col = load2(&s[0].color.r, &s[1].color.r);
+    SpriteVertex* a = out;
+    SpriteVertex* b = out + 4;
+
+    store2(&a[0].x, &b[0].x, _mm256_shuffle_ps(q, uv, _MM_SHUFFLE(1, 0, 1, 0)));
+    store2(&a[1].x, &b[1].x, _mm256_shuffle_ps(q, uv, _MM_SHUFFLE(1, 2, 1, 2)));
+    store2(&a[2].x, &b[2].x, _mm256_shuffle_ps(q, uv, _MM_SHUFFLE(3, 0, 3, 0)));
+    store2(&a[3].x, &b[3].x, _mm256_shuffle_ps(q, uv, _MM_SHUFFLE(3, 2, 3, 2)));
+    for (int c = 0; c < 4; ++c) {
+        store2(&a[c].r, &b[c].r, col);
+        a[c].flags = flags[0];
+        b[c].flags = flags[1];
+    }
+}
+
+GFX_TARGET_AVX2 static void verticesAVX2(const Sprite* s, const std::uint32_t* flags, size_t n, SpriteVertex* out) {
+    alignas(16) float sn[kBlock + 3], cs[kBlock + 3];
+    for (size_t base = 0; base < n; base += kBlock) {
+        const size_t m = std::min(kBlock, n - base);
+        const Sprite* bs = s + base;
+        const std::uint32_t* bf = flags + base;
+        const bool rotated = blockSinCos(bs, m, sn, cs);
+        size_t i = 0;
+        while (i < m) {
+            if (i + 1 < m && bs[i].rotation == 0.0f && bs[i + 1].rotation == 0.0f) {
+                quadPairAVX2(bs + i, bf + i, out);
+                i += 2;
+                out += 8;
+                continue;
+            }
+            if (rotated && bs[i].rotation != 0.0f) rotatedQuadSSE2(bs[i], bf[i], cs[i], sn[i], out);
+            else quadSSE2(bs[i], bf[i], out);
+            ++i;
+            out += 4;
+        }
+    }
+}
+
+GFX_TARGET_AVX2 static void packedAVX2(const Sprite* s, const std::uint32_t* flags, size_t n, SpritePackedVertex* out) {
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 unorm16 = _mm_set1_ps(65535.0f);
+    alignas(16) float sn[kBlock + 3], cs[kBlock + 3];
+    for (size_t base = 0; base < n; base += kBlock) {
+        const size_t m = std::min(kBlock, n - base);
+        const bool rotated = blockSinCos(s + base, m, sn, cs);
+        for (size_t i = 0; i < m; ++i, out += 4) {
+            const Sprite& sp = s[base + i];
+            const std::uint32_t f = flags[base + i];
+
+            __m128 p01, p23;                                                     // corner xy pairs
+            if (rotated && sp.rotation != 0.0f) {
+                rotatedCornersSSE2(sp, cs[i], sn[i], p01, p23);
+            }
+            else {
+                const __m128 ps = _mm_loadu_ps(&sp.pos.x);
+                const __m128 q = _mm_add_ps(ps, _mm_movelh_ps(zero, ps));       // x0 y0 x1 y1
+                p01 = _mm_shuffle_ps(q, q, _MM_SHUFFLE(1, 2, 1, 0));             // x0 y0 x1 y0
+                p23 = _mm_shuffle_ps(q, q, _MM_SHUFFLE(3, 2, 3, 0));             // x0 y1 x1 y1
+            }
+            const __m128i xy = _mm256_cvtps_ph(
+                _mm256_insertf128_ps(_mm256_castps128_ps256(p01), p23, 1), _MM_FROUND_TO_NEAREST_INT);
+
+            __m128 uv = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(&sp.uv.x), zero), one);
+            uv = _mm_mul_ps(uv, unorm16);
+            const __m128i t01 = _mm_cvtps_epi32(_mm_shuffle_ps(uv, uv, _MM_SHUFFLE(1, 2, 1, 0))); // u0 v0 u1 v0
+            const __m128i t23 = _mm_cvtps_epi32(_mm_shuffle_ps(uv, uv, _MM_SHUFFLE(3, 2, 3, 0))); // u0 v1 u1 v1
+            const __m128i uvp = _mm_packus_epi32(t01, t23);
+
+            const std::uint32_t rgba = packColorSSE2(_mm_loadu_ps(&sp.color.r));
+            const __m128i cf = _mm_set_epi32(static_cast<int>(f), static_cast<int>(rgba),
+                static_cast<int>(f), static_cast<int>(rgba));                    // rgba f rgba f
+
+            const __m128i lo = _mm_unpacklo_epi32(xy, uvp);                      // xy0 uv0 xy1 uv1
+            const __m128i hi = _mm_unpackhi_epi32(xy, uvp);                      // xy2 uv2 xy3 uv3
+            // One store per vertex
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&out[0]), _mm_unpacklo_epi64(lo, cf));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&out[1]), _mm_unpackhi_epi64(lo, cf));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&out[2]), _mm_unpacklo_epi64(hi, cf));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&out[3]), _mm_unpackhi_epi64(hi, cf));
+        }
+    }
+}
+#endif
+
+const SpriteKernels& spriteKernels(SimdLevel level) {
+    static const SpriteKernels scalar{ verticesScalar, packedScalar, instancesScalar,
+        pointVerticesScalar, pointPackedScalar, pointInstancesScalar };
+#if GFX_SIMD_X86
+    // No F16C below AVX2, so packed vertices stay scalar at the SSE2 tier
+    static const SpriteKernels sse2{ verticesSSE2, packedScalar, instancesSSE2,
+        pointVerticesScalar, pointPackedScalar, pointInstancesScalar };
+    static const SpriteKernels avx2{ verticesAVX2, packedAVX2, instancesSSE2,
+        pointVerticesScalar, pointPackedScalar, pointInstancesScalar };
+    switch (level) {
+    case SimdLevel::AVX2: return avx2;
+    case SimdLevel::SSE2: return sse2;
+    default: break;
+    }
+#else
+    (void)level;
+#endif
+    return scalar;
+}
@@ -0,0 +1,12 @@
+#include "gfx/StaticSpriteBatch.hpp"
+#include "gfx/RenderDevice.hpp"
+
+void StaticSpriteBatch::shutdown() {
+    if (m_recordTex) device().deleteTextures(1, &m_recordTex), m_recordTex = 0;
+    if (m_ebo) device().deleteBuffers(1, &m_ebo), m_ebo = 0;
+    if (m_vbo) device().deleteBuffers(1, &m_vbo), m_vbo = 0;
+    if (m_vao) device().deleteVertexArrays(1, &m_vao), m_vao = 0;
+    m_runs.clear();
+    m_spriteCount = 0;
+    m_dirty = true;
+}
@@ -0,0 +1,147 @@
+#include "gfx/StreamBuffer.hpp"
+#include "gfx/RenderDevice.hpp"
+#include <cstring>
+#include <iostream>
+
+bool StreamBuffer::init(GLenum target, size_t bytes, StreamMode mode) {
+    shutdown();
+    m_target = target;
+    m_mode = mode;
+    m_stats = {};
+
+    device().genBuffers(1, &m_buf);
+    return resize(bytes);
+}
+
+void StreamBuffer::shutdown() {
+    dropFences();
+    if (m_buf) device().deleteBuffers(1, &m_buf), m_buf = 0;
+    m_capacity = 0;
+    m_cursor = 0;
+}
+
+bool StreamBuffer::resize(size_t bytes) {
+    if (!m_buf || bytes == 0) return false;
+
+    // Pending fences refer to the old store; orphaning it makes them irrelevant
+    dropFences();
+    m_capacity = bytes;
+    m_cursor = 0;
+
+    device().bindBuffer(m_target, m_buf);
+    device().bufferData(m_target, static_cast<GLsizeiptr>(m_capacity), nullptr,
+        m_mode == StreamMode::SubData ? GL_DYNAMIC_DRAW : GL_STREAM_DRAW);
+    return true;
+}
+
+size_t StreamBuffer::write(const void* data, size_t bytes, size_t align) {
+    if (bytes > m_capacity) {
+        // Caller outgrew the ring; keep working rather than corrupt memory
+        std::cerr << "[StreamBuffer] write of " << bytes << " bytes exceeds ring of "
+            << m_capacity << ", growing\n";
+        resize(bytes * 2);
+    }
+
+    ++m_stats.writes;
+    m_stats.bytes += bytes;
+
+    device().bindBuffer(m_target, m_buf);
+
+    if (m_mode == StreamMode::SubData) {
+        device().bufferSubData(m_target, 0, static_cast<GLsizeiptr>(bytes), data);
+        m_lastBegin = 0;
+        m_lastEnd = bytes;
+        return 0;
+    }
+
+    // Round the cursor up so the offset is a whole number of elements
+    size_t offset = (align > 1) ? (m_cursor + align - 1) / align * align : m_cursor;
+    if (offset + bytes > m_capacity) {
+        // The tail [cursor, capacity) is skipped this lap: retire its fences (they are from
+        // the previous lap, so normally signalled) instead of letting them pile up
+        if (m_mode == StreamMode::Unsynchronized) retireFrom(m_cursor);
+        offset = 0;
+        ++m_stats.wraps;
+        if (m_mode == StreamMode::Orphan) {
+            // Fresh store; the driver keeps the old one alive until in-flight draws finish
+            device().bufferData(m_target, static_cast<GLsizeiptr>(m_capacity), nullptr, GL_STREAM_DRAW);
+        }
+    }
+
+    if (m_mode == StreamMode::Unsynchronized) waitForRange(offset, offset + bytes);
+
+    // Either orphaned or fenced: nobody is reading this range, so skip the driver's implicit sync
+    void* dst = device().mapBufferRange(m_target, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(bytes),
+        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+    if (dst) {
+        std::memcpy(dst, data, bytes);
+        device().unmapBuffer(m_target);
+    }
+    else {
+        device().bufferSubData(m_target, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(bytes), data);
+    }
+
+    m_lastBegin = offset;
+    m_lastEnd = offset + bytes;
+    m_cursor = m_lastEnd;
+    return offset;
+}
+
+void StreamBuffer::fence() {
+    if (m_mode != StreamMode::Unsynchronized || m_lastEnd == m_lastBegin) return;
+    GLsync s = device().fenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    if (s) m_fences.push_back({ s, m_lastBegin, m_lastEnd });
+    m_fencedBegin = m_lastBegin;
+    m_fencedEnd = m_lastEnd;
+    m_lastBegin = m_lastEnd;
+}
+
+void StreamBuffer::refence() {
+    if (m_mode != StreamMode::Unsynchronized || m_fencedEnd == m_fencedBegin) return;
+    // Queued at the back; waitForRange checks the whole queue, so the position does not matter
+    GLsync s = device().fenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    if (s) m_fences.push_back({ s, m_fencedBegin, m_fencedEnd });
+}
+
+void StreamBuffer::fenceRange(size_t begin, size_t end) {
+    if (m_mode != StreamMode::Unsynchronized || end <= begin) return;
+    GLsync s = device().fenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    if (s) m_fences.push_back({ s, begin, end });
+}
+
+void StreamBuffer::waitForRange(size_t begin, size_t end) {
+    // Fences are in submission order, which is not ring order (refence() re-queues a region
+    // behind newer ones, regions are variable-sized), so check every one; the queue is a few
+    // flushes long. The GPU signals them in order, so waiting oldest-first costs nothing extra.
+    for (auto it = m_fences.begin(); it != m_fences.end();) {
+        if (it->end <= begin || it->begin >= end) { ++it; continue; }
+        waitAndDelete(it->sync);
+        it = m_fences.erase(it);
+    }
+}
+
+void StreamBuffer::retireFrom(size_t begin) {
+    for (auto it = m_fences.begin(); it != m_fences.end();) {
+        if (it->begin < begin) { ++it; continue; }
+        waitAndDelete(it->sync);
+        it = m_fences.erase(it);
+    }
+}
+
+void StreamBuffer::waitAndDelete(GLsync sync) {
+    GLenum res = device().clientWaitSync(sync, 0, 0);
+    if (res == GL_TIMEOUT_EXPIRED) {
+        ++m_stats.stalls;
+        do {
+            res = device().clientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, 1'000'000); // 1 ms
+        } while (res == GL_TIMEOUT_EXPIRED);
+    }
+    device().deleteSync(sync);
+}
+
+void StreamBuffer::dropFences() {
+    for (const Region& r : m_fences) device().deleteSync(r.sync);
+    m_fences.clear();
+    m_lastBegin = m_lastEnd = 0;
+    m_fencedBegin = m_fencedEnd = 0;
+}
@@ -1,7 +1,20 @@
 #include "gfx/Texture2D.hpp"
+#include "gfx/FrameStats.hpp"
+#include "gfx/RenderDevice.hpp"
 #include "thirdparty/stb_image.h"
 #include <iostream>
 
+bool alphaIsOpaque(const unsigned char* pixels, int width, int height, int channels)
+{
+	// Grey (1) and RGB (3) have no alpha; grey+alpha (2) and RGBA (4) keep it in the last channel
+	if (channels != 2 && channels != 4) return true;
+	const size_t n = static_cast<size_t>(width) * static_cast<size_t>(height);
+	const size_t stride = static_cast<size_t>(channels);
+	for (size_t i = 0; i < n; ++i)
+		if (pixels[i * stride + stride - 1] != 255) return false;
+	return true;
+}
+
 bool Texture2D::load(const char* path, bool nearest)
 {
 	destroy();
@@ -15,35 +28,38 @@ bool Texture2D::load(const char* path, bool nearest)
 	}
 
 	GLenum format = channelAmount == 4 ? GL_RGBA : channelAmount == 3 ? GL_RGB : GL_RED;
+	opaque = alphaIsOpaque(pixels, width, height, channelAmount);
 
 	GLint prevUnpack = 0;
-	glGetIntegerv(GL_UNPACK_ALIGNMENT, &prevUnpack);
+	device().getIntegerv(GL_UNPACK_ALIGNMENT, &prevUnpack);
 
-	if ((width * channelAmount) % 4 != 0) glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	if ((width * channelAmount) % 4 != 0) device().pixelStorei(GL_UNPACK_ALIGNMENT, 1);
 	
-	glGenTextures(1, &id);
-	glBindTexture(GL_TEXTURE_2D, id);
+	device().genTextures(1, &id);
+	device().bindTexture(GL_TEXTURE_2D, id);
 
 	//crisp font default nearest
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, nearest ? GL_NEAREST : GL_LINEAR_MIPMAP_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, nearest ? GL_NEAREST : GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	device().texParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, nearest ? GL_NEAREST : GL_LINEAR_MIPMAP_LINEAR);
+	device().texParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, nearest ? GL_NEAREST : GL_LINEAR);
+	device().texParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	device().texParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
-	glTexImage2D(GL_TEXTURE_2D, 0, 
+	device().texImage2D(GL_TEXTURE_2D, 0, 
 		(format == GL_RGBA) ? GL_RGBA8 : (format == GL_RGB) ? GL_RGB8 : GL_R8, 
 		width, height, 0, format, GL_UNSIGNED_BYTE, pixels);
 
-	if (!nearest) glGenerateMipmap(GL_TEXTURE_2D);
+	if (!nearest) device().generateMipmap(GL_TEXTURE_2D);
 
-	if ((width * channelAmount) % 4 != 0) glPixelStorei(GL_UNPACK_ALIGNMENT, prevUnpack);
-	glBindTexture(GL_TEXTURE_2D, 0);
+	if ((width * channelAmount) % 4 != 0) device().pixelStorei(GL_UNPACK_ALIGNMENT, prevUnpack);
+	device().bindTexture(GL_TEXTURE_2D, 0);
+	++frameStats().textureUploads;
+	frameStats().textureBytes += static_cast<unsigned long long>(width) * height * channelAmount;
 	stbi_image_free(pixels);
 	return true;
 }
 
 void Texture2D::destroy()
 {
-	if (id) glDeleteTextures(1, &id), id = 0;
+	if (id) device().deleteTextures(1, &id), id = 0;
 }
 
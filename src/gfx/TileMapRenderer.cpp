@@ -0,0 +1,171 @@
+#include "gfx/TileMapRenderer.hpp"
+#include "gfx/FrameStats.hpp"
+#include "gfx/RenderDevice.hpp"
+#include "gfx/SpriteBatch.hpp"
+#include <algorithm>
+#include <cmath>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+bool TileMapRenderer::init(const char* vsPath, const char* fsPath, int width, int height, float tileSize,
+    glm::vec2 origin, const TileAtlas& atlas, int chunkTiles) {
+    shutdown();
+    if (!m_prog.loadFromFiles(vsPath, fsPath)) return false;
+    m_uTileToWorld = m_prog.uniformLocation("u_TileToWorld");
+    m_uAtlasCols = m_prog.uniformLocation("u_AtlasCols");
+    m_uAtlasRows = m_prog.uniformLocation("u_AtlasRows");
+    m_uMode = m_prog.uniformLocation("u_Mode");
+    // uTex[0] samples unit 0, the sampler default
+
+    // One uint record per tile, divisor 1; the buffer is pointed at in draw()
+    device().genVertexArrays(1, &m_vao);
+    device().bindVertexArray(m_vao);
+    device().enableVertexAttribArray(0);
+    device().vertexAttribDivisor(0, 1);
+    device().bindVertexArray(0);
+
+    m_width = std::max(width, 0);
+    m_height = std::max(height, 0);
+    m_tileSize = tileSize;
+    m_origin = origin;
+    m_atlas = atlas;
+    m_chunkTiles = std::clamp(chunkTiles, 1, 256);
+    m_chunksX = (m_width + m_chunkTiles - 1) / m_chunkTiles;
+    m_chunksY = (m_height + m_chunkTiles - 1) / m_chunkTiles;
+    m_tiles.assign(static_cast<size_t>(m_width) * m_height, kEmpty);
+    m_chunks.assign(static_cast<size_t>(m_chunksX) * m_chunksY, Chunk{});
+    return true;
+}
+
+void TileMapRenderer::shutdown() {
+    for (Chunk& c : m_chunks) {
+        if (c.vbo) device().deleteBuffers(1, &c.vbo);
+    }
+    m_chunks.clear();
+    if (m_vao) device().deleteVertexArrays(1, &m_vao), m_vao = 0;
+    m_prog.destroy();
+    m_tiles.clear();
+    m_scratch.clear();
+    m_width = m_height = 0;
+    m_chunksX = m_chunksY = 0;
+}
+
+void TileMapRenderer::set(int x, int y, Tile t) {
+    if (x < 0 || y < 0 || x >= m_width || y >= m_height) return;
+    Tile& cur = m_tiles[static_cast<size_t>(y) * m_width + x];
+    if (cur == t) return;
+    cur = t;
+    chunk(x / m_chunkTiles, y / m_chunkTiles).dirty = true;
+}
+
+TileMapRenderer::Tile TileMapRenderer::get(int x, int y) const {
+    if (x < 0 || y < 0 || x >= m_width || y >= m_height) return kEmpty;
+    return m_tiles[static_cast<size_t>(y) * m_width + x];
+}
+
+void TileMapRenderer::assign(std::span<const Tile> tiles) {
+    const size_t n = std::min(tiles.size(), m_tiles.size());
+    std::copy_n(tiles.begin(), n, m_tiles.begin());
+    std::fill(m_tiles.begin() + static_cast<std::ptrdiff_t>(n), m_tiles.end(), kEmpty);
+    for (Chunk& c : m_chunks) c.dirty = true;
+}
+
+Rect2D TileMapRenderer::bounds() const {
+    return { m_origin, m_origin + glm::vec2(static_cast<float>(m_width), static_cast<float>(m_height)) * m_tileSize };
+}
+
+TileMapRenderer::ChunkRange TileMapRenderer::visibleChunks(const Rect2D& view) const {
+    if (m_chunksX == 0 || m_chunksY == 0 || !view.overlaps(bounds())) return { 0, 0, -1, -1 };
+    const float chunkSize = m_tileSize * static_cast<float>(m_chunkTiles);
+    auto index = [chunkSize](float v, float o, int count) {
+        const float c = std::floor((v - o) / chunkSize);
+        return static_cast<int>(std::clamp(c, 0.0f, static_cast<float>(count - 1)));
+    };
+    return { index(view.min.x, m_origin.x, m_chunksX), index(view.min.y, m_origin.y, m_chunksY),
+             index(view.max.x, m_origin.x, m_chunksX), index(view.max.y, m_origin.y, m_chunksY) };
+}
+
+void TileMapRenderer::bake(int cx, int cy) {
+    const int x0 = cx * m_chunkTiles, y0 = cy * m_chunkTiles;
+    const int x1 = std::min(x0 + m_chunkTiles, m_width), y1 = std::min(y0 + m_chunkTiles, m_height);
+
+    // cell x | cell y << 8 | tile id << 16; empty tiles and ids outside the atlas get no record
+    m_scratch.clear();
+    for (int y = y0; y < y1; ++y) {
+        const Tile* row = &m_tiles[static_cast<size_t>(y) * m_width];
+        for (int x = x0; x < x1; ++x) {
+            if (!m_atlas.contains(row[x])) continue;
+            m_scratch.push_back(static_cast<std::uint32_t>(x - x0) | static_cast<std::uint32_t>(y - y0) << 8 |
+                static_cast<std::uint32_t>(row[x]) << 16);
+        }
+    }
+
+    Chunk& c = chunk(cx, cy);
+    c.count = static_cast<int>(m_scratch.size());
+    c.dirty = false;
+    if (c.count > 0) {
+        if (!c.vbo) device().genBuffers(1, &c.vbo);
+        const size_t bytes = m_scratch.size() * sizeof(std::uint32_t);
+        device().bindBuffer(GL_ARRAY_BUFFER, c.vbo);
+        device().bufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(bytes), m_scratch.data(), GL_STATIC_DRAW);
+        frameStats().uploadBytes += bytes;
+    }
+    ++m_bakes;
+}
+
+int TileMapRenderer::draw(SpriteBatch& batch, const OrthoCamera2D& cam) {
+    const ChunkRange r = visibleChunks(cam.visibleRect());
+    if (r.x0 > r.x1) return 0;
+
+    // Queued sprites draw underneath; the batch's next flush switches its program back
+    batch.submitQueued();
+    m_prog.use();
+    device().bindVertexArray(m_vao);
+    device().activeTexture(GL_TEXTURE0);
+    device().bindTexture(GL_TEXTURE_2D, m_atlas.texture);
+    device().uniform1i(m_uAtlasCols, m_atlas.cols);
+    device().uniform1i(m_uAtlasRows, m_atlas.rows);
+    device().uniform1i(m_uMode, batch.sampleMode());
+
+    FrameStats& fs = frameStats();
+    ++fs.textureBinds;
+    const float chunkSize = m_tileSize * static_cast<float>(m_chunkTiles);
+    int drawn = 0;
+    for (int cy = r.y0; cy <= r.y1; ++cy) {
+        for (int cx = r.x0; cx <= r.x1; ++cx) {
+            Chunk& c = chunk(cx, cy);
+            if (c.dirty) bake(cx, cy);
+            if (c.count == 0) continue;
+
+            const glm::vec2 base = m_origin + glm::vec2(static_cast<float>(cx), static_cast<float>(cy)) * chunkSize;
+            glm::mat4 tileToWorld = glm::translate(glm::mat4(1.0f), glm::vec3(base, 0.0f));
+            tileToWorld = glm::scale(tileToWorld, glm::vec3(m_tileSize, m_tileSize, 1.0f));
+            device().uniformMatrix4fv(m_uTileToWorld, 1, GL_FALSE, glm::value_ptr(tileToWorld));
+
+            // No base instance in GL 3.3: point the record attribute at this chunk's buffer
+            device().bindBuffer(GL_ARRAY_BUFFER, c.vbo);
+            device().vertexAttribIPointer(0, 1, GL_UNSIGNED_INT, sizeof(std::uint32_t), nullptr);
+            device().drawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, c.count);
+            ++fs.drawCalls;
+            fs.sprites += static_cast<unsigned long long>(c.count);
+            fs.vertices += static_cast<unsigned long long>(c.count) * 4;
+            ++drawn;
+        }
+    }
+    device().bindVertexArray(0);
+    return drawn;
+}
+
+void TileMapRenderer::releaseHidden(const OrthoCamera2D& cam) {
+    const ChunkRange r = visibleChunks(cam.visibleRect());
+    for (int cy = 0; cy < m_chunksY; ++cy) {
+        for (int cx = 0; cx < m_chunksX; ++cx) {
+            if (cx >= r.x0 && cx <= r.x1 && cy >= r.y0 && cy <= r.y1) continue;
+            Chunk& c = chunk(cx, cy);
+            if (c.vbo) device().deleteBuffers(1, &c.vbo), c.vbo = 0;
+            c.count = 0;
+            c.dirty = true;
+        }
+    }
+}
@@ -1,4 +1,7 @@
 #include "gfx/TriangleRenderer.hpp"
+#include "gfx/FrameData.hpp"
+#include "gfx/FrameStats.hpp"
+#include "gfx/RenderDevice.hpp"
 #include <array>
 #include <cstddef>
 #include <iostream>
@@ -24,35 +27,36 @@ static constexpr std::array<unsigned int, 6> kIndices = { 0, 1, 2, 2, 1, 3 };
 bool TriangleRenderer::init(const char* vsPath, const char* fsPath, const char* texturePath) {
     // 1) Program
     if (!m_prog.loadFromFiles(vsPath, fsPath)) return false;
-    m_uMVP = m_prog.uniformLocation("u_MVP");
+    m_uModel = m_prog.uniformLocation("u_Model");
     m_uTex = m_prog.uniformLocation("uTex");
 
     // 2) Buffers
-    glGenVertexArrays(1, &m_vao);
-    glGenBuffers(1, &m_vbo);
-    glGenBuffers(1, &m_ebo);
+    device().genVertexArrays(1, &m_vao);
+    device().genBuffers(1, &m_vbo);
+    device().genBuffers(1, &m_ebo);
 
-    glBindVertexArray(m_vao);
+    device().bindVertexArray(m_vao);
 
-    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(kVertices), kVertices.data(), GL_STATIC_DRAW);
+    device().bindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    device().bufferData(GL_ARRAY_BUFFER, sizeof(kVertices), kVertices.data(), GL_STATIC_DRAW);
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(kIndices), kIndices.data(), GL_STATIC_DRAW);
+    device().bindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
+    device().bufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(kIndices), kIndices.data(), GL_STATIC_DRAW);
+    frameStats().uploadBytes += sizeof(kVertices) + sizeof(kIndices);
 
     // Attributes: stride = (2 pos + 2 uv) * float
     constexpr GLsizei stride = static_cast<GLsizei>((2 + 2) * sizeof(float));
 
     // aPos = location 0
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<void*>(0));
+    device().enableVertexAttribArray(0);
+    device().vertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<void*>(0));
 
     // aUV = location 1 (offset = 2 floats)
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<void*>(2 * sizeof(float)));
+    device().enableVertexAttribArray(1);
+    device().vertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<void*>(2 * sizeof(float)));
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    device().bindBuffer(GL_ARRAY_BUFFER, 0);
+    device().bindVertexArray(0);
 
     // 3) Texture
     if (!loadTexture(texturePath)) return false;
@@ -76,68 +80,72 @@ bool TriangleRenderer::loadTexture(const char* path) {
 
     // If row alignment isnt multiple of 4, fix unpack alignment
     GLint prevUnpack = 0;
-    glGetIntegerv(GL_UNPACK_ALIGNMENT, &prevUnpack);
-    if ((w * comp) % 4 != 0) glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    device().getIntegerv(GL_UNPACK_ALIGNMENT, &prevUnpack);
+    if ((w * comp) % 4 != 0) device().pixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
-    glGenTextures(1, &m_tex);
-    glBindTexture(GL_TEXTURE_2D, m_tex);
+    device().genTextures(1, &m_tex);
+    device().bindTexture(GL_TEXTURE_2D, m_tex);
 
     // Basic sampling params (sprite-friendly)
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR); // smooth + mipmaps
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);               // smooth
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);            // avoid bleeding
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    device().texParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR); // smooth + mipmaps
+    device().texParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);               // smooth
+    device().texParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);            // avoid bleeding
+    device().texParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
     // Upload
-    glTexImage2D(GL_TEXTURE_2D, 0,
+    device().texImage2D(GL_TEXTURE_2D, 0,
         (format == GL_RGBA || format == GL_RGB) ? (format == GL_RGBA ? GL_RGBA8 : GL_RGB8) : GL_R8,
         w, h, 0, format, GL_UNSIGNED_BYTE, pixels);
-    glGenerateMipmap(GL_TEXTURE_2D);
+    device().generateMipmap(GL_TEXTURE_2D);
 
     // Restore unpack alignment
-    if ((w * comp) % 4 != 0) glPixelStorei(GL_UNPACK_ALIGNMENT, prevUnpack);
+    if ((w * comp) % 4 != 0) device().pixelStorei(GL_UNPACK_ALIGNMENT, prevUnpack);
 
+    ++frameStats().textureUploads;
+    frameStats().textureBytes += static_cast<unsigned long long>(w) * h * comp;
     stbi_image_free(pixels);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    device().bindTexture(GL_TEXTURE_2D, 0);
 
     return true;
 }
 
 void TriangleRenderer::draw(int fbw, int fbh) {
     m_prog.use();
-    glBindVertexArray(m_vao);
+    device().bindVertexArray(m_vao);
 
     // Bind texture to unit 0 and set sampler
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, m_tex);
-    if (m_uTex != -1) glUniform1i(m_uTex, 0);
+    device().activeTexture(GL_TEXTURE0);
+    device().bindTexture(GL_TEXTURE_2D, m_tex);
+    if (m_uTex != -1) device().uniform1i(m_uTex, 0);
 
-    // Build orthographic MVP in **pixel units**:
+    // Orthographic view in **pixel units** through the shared FrameData block:
     // (0,0) at bottom-left, (fbw, fbh) at top-right
-    glm::mat4 P = glm::ortho(0.0f, float(fbw), 0.0f, float(fbh), -1.0f, 1.0f);
-    glm::mat4 V(1.0f);
+    frameData().setView(glm::ortho(0.0f, float(fbw), 0.0f, float(fbh), -1.0f, 1.0f));
 
     // Model transforms the unit quad to [pos .. pos+size] in pixels
     glm::mat4 M(1.0f);
     M = glm::translate(M, glm::vec3(m_posX, m_posY, 0.0f));
     M = glm::scale(M, glm::vec3(m_sizeX, m_sizeY, 1.0f));
 
-    glm::mat4 MVP = P * V * M;
-
-    if (m_uMVP != -1) {
-        glUniformMatrix4fv(m_uMVP, 1, GL_FALSE, glm::value_ptr(MVP));
+    if (m_uModel != -1) {
+        device().uniformMatrix4fv(m_uModel, 1, GL_FALSE, glm::value_ptr(M));
     }
 
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
+    device().drawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
+    FrameStats& fs = frameStats();
+    ++fs.drawCalls;
+    ++fs.textureBinds;
+    ++fs.sprites;
+    fs.vertices += 4;
 
-    glBindVertexArray(0);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    device().bindVertexArray(0);
+    device().bindTexture(GL_TEXTURE_2D, 0);
 }
 
 void TriangleRenderer::shutdown() {
-    if (m_tex) { glDeleteTextures(1, &m_tex); m_tex = 0; }
-    if (m_ebo) { glDeleteBuffers(1, &m_ebo); m_ebo = 0; }
-    if (m_vbo) { glDeleteBuffers(1, &m_vbo); m_vbo = 0; }
-    if (m_vao) { glDeleteVertexArrays(1, &m_vao); m_vao = 0; }
+    if (m_tex) { device().deleteTextures(1, &m_tex); m_tex = 0; }
+    if (m_ebo) { device().deleteBuffers(1, &m_ebo); m_ebo = 0; }
+    if (m_vbo) { device().deleteBuffers(1, &m_vbo); m_vbo = 0; }
+    if (m_vao) { device().deleteVertexArrays(1, &m_vao); m_vao = 0; }
     m_prog.destroy();
 }